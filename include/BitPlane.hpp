@@ -0,0 +1,169 @@
+#ifndef BIT_PLANE_HPP
+#define BIT_PLANE_HPP
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* One bit per cell, packed into 64-bit words. Bits past size_ in the last word are always zero. */
+class BitPlane
+{
+private:
+	std::size_t size_;
+	std::vector<std::uint64_t> words_;
+
+public:
+	BitPlane() : size_(0)
+	{
+	}
+
+	void Reset(std::size_t size)
+	{
+		size_ = size;
+		words_.assign((size + 63) / 64, 0);
+	}
+
+	void Clear()
+	{
+		std::fill(words_.begin(), words_.end(), 0);
+	}
+
+	void Fill()
+	{
+		std::fill(words_.begin(), words_.end(), ~std::uint64_t{ 0 });
+
+		if (!words_.empty())
+		{
+			words_.back() &= GetTailMask();
+		}
+	}
+
+	bool Get(std::size_t index) const
+	{
+		return (words_[index >> 6] >> (index & 63)) & 1;
+	}
+
+	void Set(std::size_t index)
+	{
+		words_[index >> 6] |= std::uint64_t{ 1 } << (index & 63);
+	}
+
+	void Unset(std::size_t index)
+	{
+		words_[index >> 6] &= ~(std::uint64_t{ 1 } << (index & 63));
+	}
+
+	void Assign(std::size_t index, bool value)
+	{
+		value ? Set(index) : Unset(index);
+	}
+
+	void Flip(std::size_t index)
+	{
+		words_[index >> 6] ^= std::uint64_t{ 1 } << (index & 63);
+	}
+
+	std::size_t Count() const
+	{
+		std::size_t count = 0;
+
+		for (std::uint64_t word : words_)
+		{
+			count += std::bitset<64>(word).count();
+		}
+
+		return count;
+	}
+
+	std::size_t GetSize() const
+	{
+		return size_;
+	}
+
+	std::size_t GetWordCount() const
+	{
+		return words_.size();
+	}
+
+	/* Mask of the bits of the last word that belong to the plane. */
+	std::uint64_t GetTailMask() const
+	{
+		return (size_ & 63) == 0 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << (size_ & 63)) - 1;
+	}
+
+	const std::uint64_t* GetWords() const
+	{
+		return words_.data();
+	}
+
+	std::uint64_t* GetWords()
+	{
+		return words_.data();
+	}
+
+	std::size_t GetMemoryUsage() const
+	{
+		return words_.capacity() * sizeof(std::uint64_t);
+	}
+};
+
+/* Four bits per cell, two cells per byte. Holds values 0 to 15. */
+class NibblePlane
+{
+private:
+	std::size_t size_;
+	std::vector<std::uint8_t> bytes_;
+
+public:
+	NibblePlane() : size_(0)
+	{
+	}
+
+	void Reset(std::size_t size)
+	{
+		size_ = size;
+		bytes_.assign((size + 1) / 2, 0);
+	}
+
+	void Clear()
+	{
+		std::fill(bytes_.begin(), bytes_.end(), 0);
+	}
+
+	int Get(std::size_t index) const
+	{
+		return (bytes_[index >> 1] >> ((index & 1) * 4)) & 0x0F;
+	}
+
+	void Set(std::size_t index, int value)
+	{
+		const int shift = (index & 1) * 4;
+		std::uint8_t& byte = bytes_[index >> 1];
+
+		byte = static_cast<std::uint8_t>((byte & ~(0x0F << shift)) | ((value & 0x0F) << shift));
+	}
+
+	std::size_t GetSize() const
+	{
+		return size_;
+	}
+
+	const std::uint8_t* GetBytes() const
+	{
+		return bytes_.data();
+	}
+
+	std::uint8_t* GetBytes()
+	{
+		return bytes_.data();
+	}
+
+	std::size_t GetMemoryUsage() const
+	{
+		return bytes_.capacity();
+	}
+};
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef BOARD_HPP
+#define BOARD_HPP
+
+#include "BitPlane.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* CUSTOM boards have no preset, they only come from snapshots and replays. */
+enum class BoardSize
+{
+	SMALL, MEDIUM, LARGE, GIANT, CUSTOM
+};
+
+enum class BoardState
+{
+	PLAYING, WON, LOST
+};
+
+struct BoardPreset
+{
+	int width_;
+	int height_;
+	int mines_;
+};
+
+/* CUSTOM gets the small preset. */
+BoardPreset GetBoardPreset(BoardSize board_size);
+
+/* Finds the preset with these dimensions and mine count. Returns false if there is none. */
+bool FindBoardPreset(int width, int height, int mines, BoardSize* board_size);
+
+/* Up to eight neighbour indices stored inline, so looking up neighbours never allocates. */
+class NeighbourIndices
+{
+private:
+	std::array<std::size_t, 8> indices_;
+	std::size_t count_;
+
+public:
+	NeighbourIndices() : indices_(), count_(0)
+	{
+	}
+
+	void Push(std::size_t index)
+	{
+		indices_[count_++] = index;
+	}
+
+	std::size_t GetCount() const
+	{
+		return count_;
+	}
+
+	const std::size_t* begin() const
+	{
+		return indices_.data();
+	}
+
+	const std::size_t* end() const
+	{
+		return indices_.data() + count_;
+	}
+};
+
+/* Complete state of a board, with its planes as raw words that can live in a file mapping. Pressed cells are 
+ * not part of it, they only follow the mouse. */
+struct BoardImage
+{
+	int width_;
+	int height_;
+	int mines_;
+	int flags_placed_;
+	int covered_safe_cells_;
+	bool mines_placed_;
+	std::uint64_t seed_;
+	BoardState state_;
+	std::size_t exploded_index_;
+
+	/* (width_ * height_ + 63) / 64 words each. */
+	const std::uint64_t* mine_words_;
+	const std::uint64_t* uncovered_words_;
+	const std::uint64_t* flag_words_;
+
+	/* (width_ * height_ + 1) / 2 bytes. */
+	const std::uint8_t* vicinity_bytes_;
+};
+
+/* Rules engine of the game. Knows nothing about SDL, cells are addressed by index or (x, y).
+ * Cell state is stored as one bitplane per flag plus a 4-bit plane for the neighbour counts.
+ * Flag and covered safe cell counters are kept up to date by every operation, so the game result is known in O(1). */
+class Board
+{
+private:
+	int width_;
+	int height_;
+	int mines_;
+	int flags_placed_;
+	int covered_safe_cells_;
+	bool mines_placed_;
+	std::uint64_t seed_;
+	std::uint64_t layout_id_;
+	BoardState state_;
+	std::size_t size_;
+	std::size_t exploded_index_;
+
+	BitPlane mine_plane_;
+	BitPlane uncovered_plane_;
+	BitPlane flag_plane_;
+	BitPlane pressed_plane_;
+	NibblePlane vicinity_plane_;
+
+	std::array<std::ptrdiff_t, 8> neighbour_offsets_;
+
+	struct Span
+	{
+		int y_;
+		int x0_;
+		int x1_;
+	};
+
+	std::vector<Span> span_stack_;
+	std::vector<std::size_t> revealed_cells_;
+
+	void UncoverSafeCell(std::size_t index);
+
+	void RevealCell(std::size_t index);
+
+	void RevealZeroRegion(std::size_t start_index);
+
+	void PushZeroSpan(int x, int y);
+
+	void Explode(std::size_t index);
+
+	void Win();
+
+public:
+	Board();
+
+	Board(int width, int height, int mines);
+
+	~Board();
+
+	void Reset(int width, int height, int mines);
+
+	void Reset();
+
+	/* Mine layouts depend only on the seed, the board dimensions and the excluded cells. */
+	void PlaceMines(std::uint64_t seed);
+
+	/* Places the mines anywhere except safe_index and, when there is room, its neighbours. */
+	void PlaceMines(std::uint64_t seed, std::size_t safe_index);
+
+	/* Places fewer mines, and lowers the mine count to match, when excluded_indices leave too few free cells. */
+	void PlaceMines(std::uint64_t seed, const std::vector<std::size_t>& excluded_indices);
+
+	bool AreMinesPlaced() const;
+
+	std::uint64_t GetSeed() const;
+
+	/* Changes whenever the dimensions or the mines may have changed and is unique across all boards, so state 
+	 * derived from a board can be kept until the id changes. Copies share the id of their source. */
+	std::uint64_t GetLayoutId() const;
+
+	BoardState Reveal(std::size_t index);
+
+	BoardState Reveal(int x, int y);
+
+	bool ToggleFlag(std::size_t index);
+
+	bool ToggleFlag(int x, int y);
+
+	BoardState Chord(std::size_t index);
+
+	BoardState Chord(int x, int y);
+
+	int GetWidth() const;
+
+	int GetHeight() const;
+
+	int GetMines() const;
+
+	int GetMinesLeft() const;
+
+	int GetFlagsPlaced() const;
+
+	int GetCoveredSafeCells() const;
+
+	std::size_t GetSize() const;
+
+	BoardState GetState() const;
+
+	/* Safe cells uncovered by the last Reveal or Chord call, in reveal order. */
+	const std::vector<std::size_t>& GetRevealedCells() const;
+
+	bool Contains(int x, int y) const;
+
+	std::size_t GetIndex(int x, int y) const;
+
+	bool IsMine(std::size_t index) const;
+
+	bool IsMineExploded(std::size_t index) const;
+
+	bool IsUncovered(std::size_t index) const;
+
+	bool IsFlagged(std::size_t index) const;
+
+	bool IsPressed(std::size_t index) const;
+
+	void SetPressed(std::size_t index, bool pressed);
+
+	void ClearPressed();
+
+	int GetMinesInVicinity(std::size_t index) const;
+
+	const BitPlane& GetUncoveredPlane() const;
+
+	const BitPlane& GetFlagPlane() const;
+
+	const BitPlane& GetPressedPlane() const;
+
+	std::size_t GetMemoryUsage() const;
+
+	NeighbourIndices GetNeighboursIndices(std::size_t cell_index) const;
+
+	/* The image points into the board and is valid until the board changes. */
+	BoardImage GetImage() const;
+
+	/* Copies image into the board, nothing is recomputed. Bits past the last cell are cleared. */
+	void Restore(const BoardImage& image);
+};
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef BOARD_GENERATOR_HPP
+#define BOARD_GENERATOR_HPP
+
+#include "Board.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+/* Seed of candidate board number `candidate` derived from the game seed. */
+std::uint64_t GetCandidateSeed(std::uint64_t seed, std::size_t candidate);
+
+/* Places mines into board so that the Solver can clear it from first_click_index without guessing.
+ * Candidate boards are generated and solved in parallel on thread_pool. Workers stop as soon as they would 
+ * only look at candidates after the best success so far, and the lowest successful candidate wins, so the 
+ * result depends only on the seed. Falls back to candidate 0 and returns false if none of max_candidates works. */
+bool GenerateNoGuessBoard(Board& board, std::uint64_t seed, std::size_t first_click_index, ThreadPool& thread_pool, std::size_t max_candidates = 100000);
+
+#endif
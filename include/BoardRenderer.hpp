@@ -0,0 +1,92 @@
+#ifndef BOARD_RENDERER_HPP
+#define BOARD_RENDERER_HPP
+
+#include "BitPlane.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <vector>
+
+class Game;
+
+/* Keeps the visible part of the board composited in a render target texture and only redraws the cells whose
+ * state changed, so an idle frame costs a single copy. Only the cell range the camera shows is drawn, so the
+ * cost follows the view size rather than the board size. Cells are drawn as quads from the sprite atlas, all 
+ * changed cells in one SDL_RenderGeometry call. Changes are found by comparing the visible rows of the board's
+ * bitplanes with copies taken when the target was last updated. Camera moves and state that affects many 
+ * cells at once, like game over or the probability overlay, invalidate the whole target. Without render 
+ * target support every frame submits the whole view, still as one call. */
+class BoardRenderer
+{
+private:
+	const Game* game_;
+	SDL_Texture* target_;
+	int target_width_;
+	int target_height_;
+	bool redraw_all_;
+
+	/* Visible cells [x0_, x1_) x [y0_, y1_) and the camera they were drawn with. */
+	int x0_;
+	int y0_;
+	int x1_;
+	int y1_;
+	int cell_size_;
+	int origin_x_;
+	int origin_y_;
+
+	BitPlane rendered_uncovered_plane_;
+	BitPlane rendered_flag_plane_;
+	BitPlane rendered_pressed_plane_;
+	bool rendered_game_over_;
+	bool rendered_hint_visible_;
+	std::size_t rendered_hint_index_;
+
+	std::vector<std::size_t> dirty_cells_;
+
+	/* Cell::quad_count quads per visible cell in row order, rewritten only for dirty cells. */
+	std::vector<SDL_Vertex> vertices_;
+	std::vector<int> indices_;
+	std::vector<int> dirty_indices_;
+
+	bool UpdateTarget();
+
+	void UpdateVisibleCells();
+
+	void GetVisibleWordRange(std::size_t* first_word, std::size_t* last_word) const;
+
+	void CollectDirtyCells();
+
+	void RememberRenderedState();
+
+	bool IsVisible(std::size_t index) const;
+
+	std::size_t GetSlot(std::size_t index) const;
+
+	void WriteCell(std::size_t index);
+
+	void AppendIndices(std::size_t slot, std::vector<int>& indices) const;
+
+	void SubmitGeometry(const std::vector<int>& indices);
+
+	void RenderHint();
+
+public:
+	explicit BoardRenderer(const Game* game);
+
+	~BoardRenderer();
+
+	/* Redraws every visible cell on the next frame. Enough after SDL_RENDER_TARGETS_RESET, which only loses the 
+	 * contents of render targets. */
+	void Invalidate();
+
+	/* Destroys the target so the next frame creates a new one, after SDL_RENDER_DEVICE_RESET lost every texture. */
+	void ReleaseTarget();
+
+	void MarkDirty(std::size_t index);
+
+	/* Brings the target up to date and copies it into the current viewport. */
+	void Render();
+};
+
+#endif
@@ -10,41 +10,44 @@
 
 class Game;
 
+/* Text button. The normal, highlighted and disabled looks are rasterized once when the text is set, so hovering 
+ * only switches between textures. Hit tests use the coordinates carried by the events. */
 class Button
 {
 private:
 	Game* game_;
 	TTF_Font* font_;
 	SDL_Point top_left_;
-	std::unique_ptr<Texture> button_texture_;
+	std::unique_ptr<Texture> normal_texture_;
+	std::unique_ptr<Texture> highlighted_texture_;
+	std::unique_ptr<Texture> disabled_texture_;
 	std::string button_text_;
 
 	bool highlighted_;
-	bool redraw_;
 	bool enabled_;
 
-	void LoadText();
-
 public:
 	Button(Game* game, TTF_Font* font, const std::string& text, int x = 0, int y = 0);
 
 	~Button();
-	
-	void UpdateButtonFlags();
 
 	void SetPosition(int x, int y);
 
 	void SetText(const std::string& text);
 
-	Texture* GetTexture();
+	void SetEnabled(bool enabled);
 
-	void HandleEvent(SDL_Event* e);
+	/* Rasterizes the three looks again, after the render device lost them. */
+	void LoadTextures();
+
+	Texture* GetTexture();
 
-	void Tick();
+	/* Updates the highlight from mouse motion events. */
+	void HandleEvent(const SDL_Event* e);
 
 	void Render();
 	
-	bool MouseOverlapsButton();
+	bool ContainsPoint(int x, int y) const;
 };
 
 #endif
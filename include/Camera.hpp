@@ -0,0 +1,59 @@
+#ifndef CAMERA_HPP
+#define CAMERA_HPP
+
+#include <SDL2/SDL.h>
+
+/* Scroll and zoom state of the board view. Positions are in view pixels at the current cell size, so the 
+ * visible cell range and the cell under the mouse are a few divisions. The board is kept inside the view 
+ * whenever it is larger than the view. */
+class Camera
+{
+private:
+	int board_width_;
+	int board_height_;
+	int view_width_;
+	int view_height_;
+	int zoom_level_;
+	int origin_x_;
+	int origin_y_;
+
+	void Clamp();
+
+public:
+	Camera();
+
+	~Camera();
+
+	/* Back to the default zoom with the top left of the board in view. */
+	void Reset(int board_width, int board_height, int view_width, int view_height);
+
+	void Pan(int dx, int dy);
+
+	/* Zooms in by steps levels, or out when steps is negative, keeping the point under (anchor_x, anchor_y) 
+	 * in place. */
+	void Zoom(int steps, int anchor_x, int anchor_y);
+
+	void CenterOn(int x, int y);
+
+	int GetCellSize() const;
+
+	int GetOriginX() const;
+
+	int GetOriginY() const;
+
+	/* Size of the part of the view the board covers. */
+	int GetVisibleWidth() const;
+
+	int GetVisibleHeight() const;
+
+	/* Cells in [x0, x1) x [y0, y1) are at least partly visible. */
+	void GetVisibleCells(int* x0, int* y0, int* x1, int* y1) const;
+
+	/* Cell rectangle in view coordinates. */
+	SDL_Rect GetCellRect(int x, int y) const;
+
+	/* Cell under a point in view coordinates. Returns false if there is none. */
+	bool GetCellAt(int view_x, int view_y, int* x, int* y) const;
+};
+
+#endif
@@ -1,40 +1,35 @@
 #ifndef CELL_HPP
 #define CELL_HPP
 
-#include "Texture.hpp"
+#include "SpriteAtlas.hpp"
 
 #include <SDL2/SDL.h>
 
-#include <memory>
+#include <cstddef>
 
 class Game;
 
+/* Lightweight view of one board cell, created on the fly for rendering. All state lives in Board. */
 class Cell
 {
 public:
-	Game* game_;
-	SDL_Rect rect_;
+	const Game* game_;
+	std::size_t index_;
 
-	bool render_cell_;
-	bool flag_;
-
-	bool mine_;
-	bool mine_exploded_;
-	bool uncovered_;
-	int mines_in_vicinity_;
-	Texture* mines_in_vicinity_texture_;
-
-	Cell(Game* game);
+	Cell(const Game* game, std::size_t index);
 
 	~Cell();
 
-	void Uncover();
+	SDL_Rect GetRect() const;
+
+	/* Number of quads WriteVertices writes. Unused quads have zero area, so every cell has fixed slots. */
+	static constexpr int quad_count = 4;
 
-	void HandleEvents();
-	
-	void Tick();
+	/* Writes quad_count quads: the grid line color, the background, the main sprite and the top layer 
+	 * (flag, digit or probability tint). */
+	void WriteVertices(SDL_Vertex* vertices) const;
 
-	void Render() const;
+	void RenderHint() const;
 };
 
 #endif
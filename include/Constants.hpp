@@ -6,6 +6,12 @@ namespace constants
 	inline constexpr char game_title[] = "Minesweeper"; 
 	inline constexpr int screen_width = 320;
 	inline constexpr int screen_height = 420;
+	inline constexpr int ticks_per_second = 60;
+	inline constexpr char save_path[] = "save.bin";
+	inline constexpr int autosave_interval_seconds = 30;
+	/* Boards larger than this are scrolled through the camera. */
+	inline constexpr int max_board_viewport_width = 1280;
+	inline constexpr int max_board_viewport_height = 800;
 } // namespace constants
 
 #endif
\ No newline at end of file
@@ -1,9 +1,20 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include "Board.hpp"
+#include "BoardRenderer.hpp"
 #include "Texture.hpp"
 #include "Cell.hpp"
 #include "Button.hpp"
+#include "Camera.hpp"
+#include "PerformanceHud.hpp"
+#include "ProbabilityEngine.hpp"
+#include "Replay.hpp"
+#include "Scheduler.hpp"
+#include "Solver.hpp"
+#include "SpriteAtlas.hpp"
+#include "TextRenderer.hpp"
+#include "ThreadPool.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
@@ -11,53 +22,94 @@
 
 #include <memory>
 #include <array>
+#include <cstdint>
 #include <vector>
 
-enum class BoardSize
-{
-	SMALL, MEDIUM, LARGE
-};
-
 class Game
 {
 private:
 	bool initialized_;
+	bool headless_;
+	bool vsync_;
 	bool running_;
+	bool redraw_;
 	bool mouse_pressed_down_;
 	bool game_started_;
-	int mines_left_;
+	bool no_guess_;
 	int seconds_elapsed_;
-	int ticks_elapsed_;
+	std::uint64_t clock_start_time_;
+	std::uint64_t clock_stop_time_;
+	std::uint64_t seed_;
 
 	SDL_Window* window_;
 
 public:
 	bool game_over_;
+	bool hint_visible_;
+	bool hint_is_mine_;
+	std::size_t hint_index_;
+	bool probability_overlay_;
 	SDL_Renderer* renderer_;
 	TTF_Font* font_;
 
 private:
+	TTF_Font* hud_font_;
+
 	Mix_Chunk* explosion_sfx_;
 
+	Scheduler scheduler_;
+	std::unique_ptr<ThreadPool> thread_pool_;
+	Solver solver_;
+
 	BoardSize board_size_;
+	BoardPreset board_preset_;
 	SDL_Rect info_viewport_;
 	SDL_Rect board_viewport_;
 
-	std::vector<Cell> board_;
-
 	std::unique_ptr<Button> small_board_button_;
 	std::unique_ptr<Button> medium_board_button_;
 	std::unique_ptr<Button> large_board_button_;
 	std::unique_ptr<Button> reset_board_button_;
 
+	std::unique_ptr<BoardRenderer> board_renderer_;
+
 public:
-	std::unique_ptr<Texture> sprites_texture_;
-	std::unique_ptr<Texture> mines_left_texture_;
-	std::unique_ptr<Texture> seconds_texture_;
+	Board board_;
+	ProbabilityEngine probability_engine_;
+	Camera camera_;
 
-	std::vector<std::unique_ptr<Texture>> mine_numbers_textures_;
+	std::unique_ptr<SpriteAtlas> sprite_atlas_;
+	std::unique_ptr<TextRenderer> text_renderer_;
 
-	Game();
+private:
+	std::unique_ptr<PerformanceHud> performance_hud_;
+	bool performance_hud_visible_;
+
+	/* Recording and playback share replay_tick_, the tick of the last record of the current game. */
+	ReplayWriter replay_writer_;
+	std::unique_ptr<ReplayReader> replay_reader_;
+	bool replaying_;
+	bool replay_game_recorded_;
+	bool replay_record_pending_;
+	ReplayRecord replay_record_;
+	std::uint64_t replay_tick_;
+	std::uint64_t replay_due_tick_;
+
+	void RecordReplayEvent(ReplayAction action, std::size_t index);
+
+	/* Applies the replay records that are due at the current tick. */
+	void PlayReplay();
+
+	/* Recreates every texture drawn from, after SDL_RENDER_DEVICE_RESET lost them with the old device. */
+	void ReloadTextures();
+
+	const char* autosave_path_;
+	std::uint64_t autosave_time_;
+
+public:
+	/* A headless game renders offscreen with the software renderer, for benchmarks on machines without a display. 
+	 * vsync waits for the display's refresh on every present. */
+	explicit Game(bool headless = false, bool vsync = false);
 
 	~Game();
 
@@ -65,7 +117,15 @@ public:
 
 	void Finalize();
 
-	void Run();
+	/* With wait_for_events the loop sleeps until input arrives or the clock is due to tick and only renders 
+	 * frames that changed, otherwise it renders as fast as it can. */
+	void Run(bool wait_for_events = true);
+
+	/* Plays frames_per_size frames on every board size, clicking what the Solver suggests or a random cell 
+	 * every few frames, and prints frame time percentiles, draw calls and texture uploads per frame. */
+	void RunFrameBenchmark(int frames_per_size);
+
+	void PushMouseClick(std::size_t index, Uint8 button);
 
 	void HandleEvents();
 	
@@ -79,13 +139,16 @@ public:
 
 	void ResizeWindow(BoardSize board_size);
 
-	void DebugBoard();
+	/* Lays the window out for boards of board_preset's dimensions, which new games use from now on. The board 
+	 * itself is left alone, the camera is reset when the dimensions change. */
+	void SetBoardPreset(const BoardPreset& board_preset);
 
-	void ResetRenderCellFlags(std::size_t current_mouse_index);
+	/* Sizes the window and viewports for board_preset_ and places the buttons. */
+	void LayoutWindow();
 
-	void UpdateMinesLeftTexture();
+	void DebugBoard();
 
-	void UpdateSecondsElapsedTexture();
+	void ResetRenderCellFlags(std::size_t current_mouse_index);
 
 	void ResetBoard();
 	
@@ -93,13 +156,37 @@ public:
 
 	bool GetMousePositionIndex(std::size_t* index);
 
-	void SetBoardCellFlags();
+	/* Game clock in scheduler time units, stopped before the first click and after the game ends. */
+	std::uint64_t GetElapsedTime() const;
+
+	/* Left click on a cell: places the mines on the first click, then reveals a covered cell or chords an uncovered one. */
+	void ClickCell(std::size_t index);
+
+	void FlagCell(std::size_t index);
+
+	/* Saves the running game to path every few seconds and when the game exits. */
+	void EnableAutosave(const char* path);
+
+	bool SaveGame(const char* path);
+
+	/* Resumes the game saved at path, whatever its board dimensions. Keeps the current game if that fails. */
+	bool LoadGame(const char* path);
+
+	/* Appends every game played from now on to the replay log at path. */
+	bool StartRecording(const char* path);
+
+	/* Plays the replay log at path in real time instead of taking input on the board. */
+	bool LoadReplay(const char* path);
 
 	void UncoverCells(std::size_t start_index);
 
 	void UncoverAvailableNeighbourCells(std::size_t start_index);
 
-	std::vector<std::size_t> GetNeighboursIndices(std::size_t cell_index);
+	void UpdateProbabilities();
+
+	void ShowHint();
+
+	void HandleBoardState(BoardState board_state);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef MINE_PLACEMENT_HPP
+#define MINE_PLACEMENT_HPP
+
+#include "BitPlane.hpp"
+#include "Random.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/* Sets `mines` distinct bits of the cleared mine_plane, uniformly at random, never on excluded_indices.
+ * Uses Floyd's sampling algorithm with the plane itself as the set, so it needs no memory of its own and 
+ * never retries. Above half density the safe cells are sampled instead, so the cost is O(min(mines, free cells)). 
+ * Returns the number of mines placed, which is smaller than requested only if the free cells run out. */
+std::size_t SampleMines(BitPlane& mine_plane, std::size_t mines, std::vector<std::size_t> excluded_indices, CounterRng& rng);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef NEIGHBOUR_COUNT_HPP
+#define NEIGHBOUR_COUNT_HPP
+
+#include "BitPlane.hpp"
+
+enum class SimdLevel
+{
+	SCALAR, SSE2, AVX2
+};
+
+/* Best instruction set the running CPU supports. */
+SimdLevel GetSupportedSimdLevel();
+
+/* Fills vicinity_plane with the number of mines around every cell of a width x height board.
+ * Works as a 3x3 box sum over the mine plane: each row is unpacked to bytes, summed horizontally, then 
+ * three row sums are added vertically and the cell itself is subtracted. */
+void CountNeighbourMines(const BitPlane& mine_plane, int width, int height, NibblePlane& vicinity_plane);
+
+void CountNeighbourMines(const BitPlane& mine_plane, int width, int height, NibblePlane& vicinity_plane, SimdLevel simd_level);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef PERFORMANCE_HUD_HPP
+#define PERFORMANCE_HUD_HPP
+
+#include "TextRenderer.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+/* Overlay with frame and tick rates, frame time percentiles and a graph over the last frames, draw calls and 
+ * texture uploads per frame and board memory. Text comes from its own small glyph atlas and the background 
+ * and graph are a fixed set of quads drawn in one call, so the overlay neither allocates nor rasterizes 
+ * glyphs once its buffers have grown. */
+class PerformanceHud
+{
+private:
+	static constexpr std::size_t window_size = 120;
+
+	/* Overlay background, graph background, frame budget line and one bar per frame. */
+	static constexpr std::size_t quad_count = window_size + 3;
+
+	std::unique_ptr<TextRenderer> text_renderer_;
+
+	/* Ring of the last window_size frame times, frame_count_ counts every frame recorded. */
+	std::array<float, window_size> frame_milliseconds_;
+	std::size_t frame_count_;
+
+	int frames_per_second_;
+	int ticks_per_second_;
+	std::size_t draw_calls_;
+	std::size_t texture_uploads_;
+
+	std::array<SDL_Vertex, quad_count * 4> vertices_;
+	std::array<int, quad_count * 6> indices_;
+
+	void GetPercentiles(float* p50, float* p99) const;
+
+	void RenderGraph(SDL_Renderer* renderer, const SDL_Rect& area);
+
+public:
+	PerformanceHud();
+
+	~PerformanceHud();
+
+	bool Load(SDL_Renderer* renderer, TTF_Font* font);
+
+	/* Time the frame took to handle events, tick and render, and what it drew. */
+	void RecordFrame(double milliseconds, std::size_t draw_calls, std::size_t texture_uploads);
+
+	void RecordSecond(int frames, int ticks);
+
+	/* Draws over area of the current viewport. */
+	void Render(SDL_Renderer* renderer, const SDL_Rect& area, std::size_t board_memory);
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef PROBABILITY_ENGINE_HPP
+#define PROBABILITY_ENGINE_HPP
+
+#include "Board.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/* Exact probability that each covered cell is a mine, given what a player can see. Flags are trusted.
+ * The covered cells next to numbers are split into independent components. Each component's mine 
+ * configurations are enumerated on the thread pool, counted by number of mines, and combined with the 
+ * binomial number of ways to place the remaining mines among the unconstrained cells. Component results are 
+ * cached by their cells and constraints, so after a move only the components it touched are enumerated again. 
+ * The game updates through RequestUpdate and Poll, which run the update on the thread pool against a copy of the 
+ * board and keep the previous probabilities readable until the new ones are ready. */
+class ProbabilityEngine
+{
+private:
+	struct Component
+	{
+		std::vector<std::size_t> cells_;
+		std::vector<std::vector<int>> constraint_cells_;
+		std::vector<int> constraint_mines_;
+		std::vector<std::uint64_t> key_;
+	};
+
+	struct ComponentResult
+	{
+		/* weights_[k]: configurations with k mines, nonzero only from min_mines_ to max_mines_. 
+		 * mine_weights_[cell * (max_mines_ - min_mines_ + 1) + k - min_mines_]: those of them with a mine on cell. 
+		 * Both are scaled so the largest weight is 1. */
+		std::vector<double> weights_;
+		std::vector<double> mine_weights_;
+		std::size_t min_mines_;
+		std::size_t max_mines_;
+		bool exact_;
+	};
+
+	ThreadPool* thread_pool_;
+	std::size_t node_limit_;
+	bool exact_;
+
+	std::vector<float> probabilities_;
+	std::vector<std::uint32_t> frontier_ids_;
+	std::map<std::vector<std::uint64_t>, ComponentResult> cache_;
+
+	/* State of the update running on the thread pool. Only that task touches it and cache_ until it is done. */
+	ThreadPool::TaskGroup update_group_;
+	Board update_board_;
+	std::vector<float> update_probabilities_;
+	bool update_exact_;
+	bool updating_;
+	bool update_requested_;
+
+	/* Returns false if a component hit the node limit. */
+	bool Compute(const Board& board, std::vector<float>& probabilities);
+
+	std::vector<Component> BuildComponents(const Board& board);
+
+	ComponentResult Enumerate(const Component& component) const;
+
+public:
+	/* Without a thread pool components are enumerated on the calling thread. */
+	explicit ProbabilityEngine(ThreadPool* thread_pool = nullptr);
+
+	~ProbabilityEngine();
+
+	/* Recomputes the probabilities for the current state of board on the calling thread, after waiting for a 
+	 * running update. */
+	void Update(const Board& board);
+
+	/* Marks the probabilities out of date, the next Poll starts the update. */
+	void RequestUpdate();
+
+	/* Publishes a finished update and starts a requested one for the current state of board on the thread pool, 
+	 * or on the calling thread without one. Returns true when new probabilities were published. */
+	bool Poll(const Board& board);
+
+	bool IsUpdating() const;
+
+	/* 0 for uncovered cells, 1 for flagged cells. */
+	float GetMineProbability(std::size_t index) const;
+
+	const std::vector<float>& GetProbabilities() const;
+
+	/* False if a component hit the enumeration limit and its cells got the unconstrained probability. */
+	bool IsExact() const;
+
+	std::size_t GetCachedComponentCount() const;
+
+	/* Search nodes one component may visit before it is given up on. The default keeps an update of a busy 
+	 * board within a few frames. Not to be changed while an update runs. */
+	void SetNodeLimit(std::size_t node_limit);
+};
+
+#endif
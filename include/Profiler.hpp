@@ -0,0 +1,56 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+/* Scoped timing zones, recorded per thread and written as a Chrome trace for chrome://tracing or 
+ * ui.perfetto.dev. Zones are only compiled with MINESWEEPER_PROFILE defined (make PROFILE=1), otherwise 
+ * PROFILE_ZONE expands to nothing. Zone names must be string literals, only the pointer is stored. */
+#ifdef MINESWEEPER_PROFILE
+
+#include <cstdint>
+
+namespace profiler
+{
+	/* Nanoseconds since the profiler started. */
+	std::uint64_t Now();
+
+	/* Appends a zone to the calling thread's ring buffer, overwriting the oldest zone when it is full. */
+	void Record(const char* name, std::uint64_t start, std::uint64_t end);
+
+	/* Writes the zones held in the ring buffers of all threads. Returns false if the file cannot be written. */
+	bool WriteTrace(const char* path);
+
+	class Zone
+	{
+	private:
+		const char* name_;
+		std::uint64_t start_;
+
+	public:
+		explicit Zone(const char* name) : 
+			name_(name), 
+			start_(Now())
+		{
+		}
+
+		~Zone()
+		{
+			Record(name_, start_, Now());
+		}
+
+		Zone(const Zone&) = delete;
+
+		Zone& operator=(const Zone&) = delete;
+	};
+} // namespace profiler
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) const profiler::Zone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+
+#else
+
+#define PROFILE_ZONE(name)
+
+#endif
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+
+/* Counter-based random number generator. Output n of stream s is a pure function of (seed, s, n), computed 
+ * with the SplitMix64 finaliser, so the same seed gives the same boards on every platform and compiler, and 
+ * independent streams can be handed to worker threads without changing the result. */
+class CounterRng
+{
+private:
+	static constexpr std::uint64_t golden_gamma = 0x9E3779B97F4A7C15;
+
+	std::uint64_t key_;
+	std::uint64_t counter_;
+
+public:
+	using result_type = std::uint64_t;
+
+	explicit CounterRng(std::uint64_t seed, std::uint64_t stream = 0) : 
+		key_(Mix(seed) ^ Mix(Mix(stream + golden_gamma))), 
+		counter_(0)
+	{
+	}
+
+	static constexpr result_type min()
+	{
+		return 0;
+	}
+
+	static constexpr result_type max()
+	{
+		return UINT64_MAX;
+	}
+
+	static constexpr std::uint64_t Mix(std::uint64_t x)
+	{
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+		return x ^ (x >> 31);
+	}
+
+	result_type operator()()
+	{
+		return Mix(key_ + golden_gamma * ++counter_);
+	}
+
+	/* Uniform value in [0, bound). Unlike std::uniform_int_distribution this is the same on every standard library. */
+	std::uint64_t UniformBelow(std::uint64_t bound)
+	{
+		const std::uint64_t threshold = (0 - bound) % bound;
+		std::uint64_t value = (*this)();
+
+		while (value < threshold)
+		{
+			value = (*this)();
+		}
+
+		return value % bound;
+	}
+
+	std::uint64_t GetCounter() const
+	{
+		return counter_;
+	}
+
+	void SetCounter(std::uint64_t counter)
+	{
+		counter_ = counter;
+	}
+};
+
+#endif
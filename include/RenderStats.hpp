@@ -0,0 +1,30 @@
+#ifndef RENDER_STATS_HPP
+#define RENDER_STATS_HPP
+
+#include <cstddef>
+
+/* Counts the work the game hands to the renderer. Only the game's own call sites count, SDL is not hooked, 
+ * so every SDL draw or texture upload call has to be paired with one of these. */
+namespace render_stats
+{
+	inline std::size_t draw_calls = 0;
+	inline std::size_t texture_uploads = 0;
+
+	inline void CountDrawCall(std::size_t count = 1)
+	{
+		draw_calls += count;
+	}
+
+	inline void CountTextureUpload()
+	{
+		++texture_uploads;
+	}
+
+	inline void Reset()
+	{
+		draw_calls = 0;
+		texture_uploads = 0;
+	}
+} // namespace render_stats
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/* Replay logs start with the magic "MSRP" and a version byte, followed by records that each start with an 
+ * action byte. A NEW_GAME record holds the seed, size, mine count and no-guess flag of the game the records after 
+ * it belong to. Every other record holds the ticks since the previous record of its game and a cell index. 
+ * Numbers are LEB128 varints, so a move usually takes three or four bytes. Logs are only ever appended to, 
+ * and a log cut off in the middle of a record still plays up to the last whole record. */
+enum class ReplayAction : std::uint8_t
+{
+	NEW_GAME, REVEAL, CHORD, FLAG
+};
+
+struct ReplayGame
+{
+	std::uint64_t seed_;
+	int width_;
+	int height_;
+	int mines_;
+	bool no_guess_;
+};
+
+struct ReplayRecord
+{
+	ReplayAction action_;
+	ReplayGame game_;
+	std::uint64_t ticks_;
+	std::size_t cell_;
+};
+
+/* Encodes records into a memory buffer that is written out when it fills up and at the end of every game, 
+ * so recording a move costs a few byte stores. */
+class ReplayWriter
+{
+private:
+	FILE* file_;
+	std::vector<std::uint8_t> buffer_;
+
+	void WriteVarint(std::uint64_t value);
+
+public:
+	ReplayWriter();
+
+	~ReplayWriter();
+
+	/* Appends to the log at path, starting it if the file is new or empty. */
+	bool Open(const char* path);
+
+	void Close();
+
+	bool IsOpen() const;
+
+	void BeginGame(const ReplayGame& game);
+
+	void WriteEvent(ReplayAction action, std::uint64_t ticks, std::size_t cell);
+
+	/* Hands the buffered records to the operating system. */
+	void Flush();
+};
+
+class ReplayReader
+{
+private:
+	std::vector<std::uint8_t> data_;
+	std::size_t position_;
+
+	bool ReadVarint(std::uint64_t* value);
+
+public:
+	ReplayReader();
+
+	~ReplayReader();
+
+	/* Reads the whole log at path and checks its header. */
+	bool Open(const char* path);
+
+	/* Reads the next record, returns false at the end of the log or at a damaged record. */
+	bool Next(ReplayRecord* record);
+};
+
+#endif
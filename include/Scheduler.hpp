@@ -0,0 +1,60 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <cstdint>
+
+/* Fixed timestep tick scheduler. Time is an integer count of clock units, performance counter ticks in the game, 
+ * and the deadline of tick n is computed from n as n * frequency / tick_rate, so no rounding error builds up 
+ * however long the game runs or however unevenly time advances. The owner either sets the time from a real 
+ * clock or advances it by hand, which makes headless runs deterministic and as fast as the machine allows. */
+class Scheduler
+{
+private:
+	std::uint64_t frequency_;
+	std::uint64_t tick_rate_;
+	std::uint64_t time_;
+	std::uint64_t ticks_;
+
+	/* Time at which tick number tick is due. */
+	std::uint64_t GetTickTime(std::uint64_t tick) const;
+
+	/* Number of ticks due up to the current time, consumed or not. */
+	std::uint64_t GetTicksDue() const;
+
+public:
+	Scheduler();
+
+	~Scheduler();
+
+	/* Starts over at time 0 with frequency clock units per second and tick_rate ticks per second. */
+	void Reset(std::uint64_t frequency, std::uint64_t tick_rate);
+
+	/* Time never goes backwards, earlier times are ignored. */
+	void SetTime(std::uint64_t time);
+
+	void Advance(std::uint64_t duration);
+
+	/* Moves the time exactly to the deadline of the next tick that has not been consumed. */
+	void AdvanceToNextTick();
+
+	/* Returns true and counts the tick if one is due. */
+	bool ConsumeTick();
+
+	/* Forgets due ticks beyond the newest max_pending, so a stall is not followed by a burst of ticks. */
+	void DropPendingTicks(std::uint64_t max_pending);
+
+	std::uint64_t GetTime() const;
+
+	std::uint64_t GetTicks() const;
+
+	std::uint64_t GetFrequency() const;
+
+	/* Zero when a tick is already due. */
+	std::uint64_t GetTimeToNextTick() const;
+
+	double ToSeconds(std::uint64_t duration) const;
+
+	std::uint64_t FromSeconds(double seconds) const;
+};
+
+#endif
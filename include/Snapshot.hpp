@@ -0,0 +1,27 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "Board.hpp"
+
+#include <cstdint>
+
+/* Game state outside the board that a snapshot keeps. */
+struct SnapshotInfo
+{
+	std::uint64_t elapsed_microseconds_;
+	bool game_started_;
+	bool no_guess_;
+};
+
+/* A snapshot is a fixed header followed by the mine, uncovered and flag bitplanes and the neighbour count 
+ * nibbles exactly as the board holds them in memory, each at a 64-byte aligned offset. Loading maps the file 
+ * and copies the planes straight into the board, there is nothing to parse, and saving is a single gathered 
+ * write of the board's own buffers. The layout is native byte order, a marker in the header rejects files 
+ * written on a machine with the other order. The version changes whenever the layout does. */
+bool SaveSnapshot(const char* path, const Board& board, const SnapshotInfo& info);
+
+/* Leaves board and info untouched and returns false if the file is missing, damaged or of another version. 
+ * Besides the header, the board's counters and state are checked against its planes. */
+bool LoadSnapshot(const char* path, Board& board, SnapshotInfo* info);
+
+#endif
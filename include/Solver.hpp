@@ -0,0 +1,100 @@
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+#include "Board.hpp"
+#include "BitPlane.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Deterministic solver and hint engine. It only uses what a player can see: uncovered numbers, flags and the 
+ * mine counter. Flags are trusted, so a wrong flag can lead to wrong deductions. Every numbered frontier cell 
+ * becomes a constraint whose unknown neighbours are a bitmask over the 7x7 window around the cell, so comparing 
+ * two constraints up to two cells apart is a shift and a few bitwise operations. Constraints are kept between 
+ * calls and only rebuilt around cells whose uncovered or flag state changed since the last call, found by 
+ * comparing the board's planes with copies a word at a time, so a call costs the size of the frontier and of 
+ * the change rather than the size of the board. A new board layout rebuilds everything. */
+class Solver
+{
+private:
+	struct Constraint
+	{
+		int x_;
+		int y_;
+		std::uint64_t unknown_mask_;
+		int mines_left_;
+
+		/* The slot is in single_point_constraints_. Belongs to the slot, not to the constraint in it. */
+		bool listed_;
+	};
+
+	/* Constraint slots, a slot with no unknown cells is free. constraint_ids_ maps a cell to its slot. */
+	std::vector<Constraint> constraints_;
+	std::vector<std::uint32_t> free_constraints_;
+	std::vector<std::uint32_t> constraint_ids_;
+
+	/* Slots whose constraint the single-point rule decided when it was last rebuilt. Constraints only change 
+	 * when they are rebuilt, so no other slot can be decided. */
+	std::vector<std::uint32_t> single_point_constraints_;
+
+	std::uint64_t layout_id_;
+	BitPlane known_uncovered_plane_;
+	BitPlane known_flag_plane_;
+
+	std::vector<std::size_t> safe_cells_;
+	std::vector<std::size_t> mine_cells_;
+	BitPlane forced_safe_plane_;
+	BitPlane forced_mine_plane_;
+
+	void Prepare(const Board& board);
+
+	void UpdateConstraints(const Board& board);
+
+	void UpdateConstraint(const Board& board, std::size_t index);
+
+	void UpdateConstraintsAround(const Board& board, std::size_t index);
+
+	/* A number whose flags already match it clears its unknown neighbours, a number that needs all of them 
+	 * makes them all mines. */
+	static bool IsSinglePointDecided(const Constraint& constraint);
+
+	void ApplySinglePointRule(const Board& board);
+
+	void ApplyPairRules(const Board& board);
+
+	void ApplyMineCounterRule(const Board& board);
+
+	void MarkWindow(const Board& board, const Constraint& constraint, std::uint64_t mask, bool mines);
+
+	void MarkSafe(std::size_t index);
+
+	void MarkMine(std::size_t index);
+
+public:
+	Solver();
+
+	~Solver();
+
+	/* Collects the covered cells that are certainly safe or certainly mines. Cheap rules run first, pair rules 
+	 * only when the single-point rule finds nothing. Returns true if any cell was found. The mine counter rule 
+	 * still scans the board, but only runs when the counter alone decides every unknown cell. */
+	bool FindForcedCells(const Board& board);
+
+	const std::vector<std::size_t>& GetSafeCells() const;
+
+	const std::vector<std::size_t>& GetMineCells() const;
+
+	bool IsForcedSafe(std::size_t index) const;
+
+	bool IsForcedMine(std::size_t index) const;
+
+	/* Next move a player can make without guessing, safe cells first. Returns false if every move is a guess. */
+	bool GetHint(const Board& board, std::size_t* index, bool* is_mine);
+
+	/* Keeps revealing forced safe cells and flagging forced mines until the game ends or no cell is forced. 
+	 * Returns true if the board was won without guessing. */
+	bool Solve(Board& board);
+};
+
+#endif
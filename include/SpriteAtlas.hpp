@@ -0,0 +1,52 @@
+#ifndef SPRITE_ATLAS_HPP
+#define SPRITE_ATLAS_HPP
+
+#include "Texture.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <array>
+#include <memory>
+
+/* One texture holding everything a cell can show: the covered, mine and flag sprites, the digits 1 to 8 in 
+ * their colors and a white block. Solid fills sample the white block and take their color from the vertices, 
+ * so a whole board can be drawn with one SDL_RenderGeometry call. */
+class SpriteAtlas
+{
+private:
+	std::unique_ptr<Texture> texture_;
+	SDL_Rect covered_rect_;
+	SDL_Rect mine_rect_;
+	SDL_Rect flag_rect_;
+	SDL_Rect white_rect_;
+	std::array<SDL_Rect, 8> digit_rects_;
+
+public:
+	SpriteAtlas();
+
+	~SpriteAtlas();
+
+	bool Load(SDL_Renderer* renderer, TTF_Font* font, const char* sprites_path);
+
+	Texture* GetTexture() const;
+
+	const SDL_Rect& GetCoveredRect() const;
+
+	const SDL_Rect& GetMineRect() const;
+
+	const SDL_Rect& GetFlagRect() const;
+
+	/* digit from 1 to 8. */
+	const SDL_Rect& GetDigitRect(int digit) const;
+
+	/* Writes the four vertices of a quad showing source at destination, tinted by color. */
+	void WriteQuad(SDL_Vertex* vertices, const SDL_Rect& destination, const SDL_Rect& source, const SDL_Color& color) const;
+
+	void WriteSolidQuad(SDL_Vertex* vertices, const SDL_Rect& destination, const SDL_Color& color) const;
+
+	/* Zero-area quad that draws nothing, for slots a cell does not use. */
+	void WriteEmptyQuad(SDL_Vertex* vertices) const;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TEXT_RENDERER_HPP
+#define TEXT_RENDERER_HPP
+
+#include "Texture.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+/* Draws text from a glyph atlas. The printable ASCII glyphs of a font are rasterized in white once, strings 
+ * become quads tinted by their vertex color, and everything queued until Flush is one SDL_RenderGeometry call.
+ * Once the buffers have grown, drawing text neither allocates nor uploads textures. Kerning is ignored. */
+class TextRenderer
+{
+private:
+	static constexpr int first_glyph = 32;
+	static constexpr int last_glyph = 126;
+
+	struct Glyph
+	{
+		SDL_Rect rect_;
+		int advance_;
+	};
+
+	std::unique_ptr<Texture> texture_;
+	std::array<Glyph, last_glyph - first_glyph + 1> glyphs_;
+	int line_height_;
+
+	std::vector<SDL_Vertex> vertices_;
+	std::vector<int> indices_;
+
+	const Glyph& GetGlyph(char character) const;
+
+public:
+	TextRenderer();
+
+	~TextRenderer();
+
+	bool Load(SDL_Renderer* renderer, TTF_Font* font);
+
+	/* Size of text in pixels, without drawing it. */
+	void MeasureText(const char* text, int* width, int* height) const;
+
+	/* Queues text with its top left corner at (x, y). */
+	void DrawText(const char* text, int x, int y, const SDL_Color& color);
+
+	/* Draws the queued text into the current viewport. */
+	void Flush(SDL_Renderer* renderer);
+};
+
+#endif
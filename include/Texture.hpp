@@ -19,6 +19,9 @@ public:
 
 	bool LoadFromPath(SDL_Renderer* renderer, const char* path);
 
+	/* Uploads surface, which stays owned by the caller. */
+	bool LoadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface);
+
 	bool LoadFromText(SDL_Renderer* renderer, TTF_Font* font, const char* text, const SDL_Color& color, int text_length);
 
 	void Render(SDL_Renderer* renderer, int x, int y, float scale = 1.0, SDL_Rect* clip = nullptr);
@@ -0,0 +1,80 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Work-stealing thread pool. Every worker owns a task deque: it pops its own newest task first and steals the 
+ * oldest task of another worker when its deque is empty. Tasks submitted from a worker go to that worker's deque. */
+class ThreadPool
+{
+public:
+	/* Tasks that are waited for together. Must outlive its tasks. */
+	class TaskGroup
+	{
+	private:
+		friend class ThreadPool;
+
+		std::atomic<std::size_t> pending_;
+
+	public:
+		TaskGroup() : pending_(0)
+		{
+		}
+
+		/* True once every submitted task has finished, and their writes are visible to the caller. */
+		bool IsDone() const
+		{
+			return pending_.load(std::memory_order_acquire) == 0;
+		}
+	};
+
+private:
+	struct WorkerQueue
+	{
+		std::mutex mutex_;
+		std::deque<std::function<void()>> tasks_;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues_;
+	std::vector<std::thread> threads_;
+
+	std::mutex wake_mutex_;
+	std::condition_variable wake_condition_;
+	std::condition_variable done_condition_;
+	std::atomic<std::size_t> queued_tasks_;
+	std::atomic<std::size_t> next_queue_;
+	bool stopping_;
+
+	void WorkerLoop(std::size_t worker_index);
+
+	bool TryRunTask(std::size_t first_queue);
+
+	bool TryPopTask(std::size_t queue_index, bool steal, std::function<void()>* task);
+
+public:
+	/* thread_count 0 uses every hardware thread. */
+	explicit ThreadPool(std::size_t thread_count = 0);
+
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void Submit(TaskGroup& task_group, std::function<void()> task);
+
+	/* Runs queued tasks on the calling thread until every task of task_group has finished. */
+	void Wait(TaskGroup& task_group);
+
+	std::size_t GetThreadCount() const;
+};
+
+#endif
@@ -0,0 +1,600 @@
+#include "Board.hpp"
+#include "MinePlacement.hpp"
+#include "NeighbourCount.hpp"
+#include "Random.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	std::uint64_t NextLayoutId()
+	{
+		static std::atomic<std::uint64_t> next_layout_id(1);
+
+		return next_layout_id.fetch_add(1, std::memory_order_relaxed);
+	}
+} // namespace
+
+BoardPreset GetBoardPreset(BoardSize board_size)
+{
+	switch (board_size)
+	{
+	case BoardSize::SMALL:
+		return { 10, 10, 10 };
+	case BoardSize::MEDIUM:
+		return { 16, 16, 40 };
+	case BoardSize::LARGE:
+		return { 32, 16, 99 };
+	case BoardSize::GIANT:
+		return { 1000, 1000, 156250 };
+	case BoardSize::CUSTOM:
+		break;
+	}
+
+	return { 10, 10, 10 };
+}
+
+bool FindBoardPreset(int width, int height, int mines, BoardSize* board_size)
+{
+	for (BoardSize candidate : { BoardSize::SMALL, BoardSize::MEDIUM, BoardSize::LARGE, BoardSize::GIANT })
+	{
+		const BoardPreset board_preset = GetBoardPreset(candidate);
+
+		if (board_preset.width_ == width && board_preset.height_ == height && board_preset.mines_ == mines)
+		{
+			*board_size = candidate;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+Board::Board() : Board(0, 0, 0)
+{
+}
+
+Board::Board(int width, int height, int mines) : 
+	width_(0), 
+	height_(0), 
+	mines_(0), 
+	flags_placed_(0), 
+	covered_safe_cells_(0), 
+	mines_placed_(false), 
+	seed_(0), 
+	layout_id_(0), 
+	state_(BoardState::PLAYING), 
+	size_(0), 
+	exploded_index_(0)
+{
+	Reset(width, height, mines);
+}
+
+Board::~Board()
+{
+}
+
+void Board::Reset(int width, int height, int mines)
+{
+	width_ = width;
+	height_ = height;
+	mines_ = std::clamp(mines, 0, width * height);
+
+	Reset();
+}
+
+void Board::Reset()
+{
+	flags_placed_ = 0;
+	covered_safe_cells_ = width_ * height_ - mines_;
+	mines_placed_ = false;
+	layout_id_ = NextLayoutId();
+	state_ = BoardState::PLAYING;
+	size_ = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+	exploded_index_ = size_;
+
+	mine_plane_.Reset(size_);
+	uncovered_plane_.Reset(size_);
+	flag_plane_.Reset(size_);
+	pressed_plane_.Reset(size_);
+	vicinity_plane_.Reset(size_);
+
+	const std::ptrdiff_t width = width_;
+	neighbour_offsets_ = { -width - 1, -width, -width + 1, -1, 1, width - 1, width, width + 1 };
+}
+
+void Board::PlaceMines(std::uint64_t seed)
+{
+	PlaceMines(seed, std::vector<std::size_t>());
+}
+
+void Board::PlaceMines(std::uint64_t seed, std::size_t safe_index)
+{
+	std::vector<std::size_t> excluded_indices;
+
+	/* Keep the whole 3x3 area around the first click free when the board has room for it. */
+	const NeighbourIndices neighbour_indices = GetNeighboursIndices(safe_index);
+
+	if (size_ - neighbour_indices.GetCount() - 1 >= static_cast<std::size_t>(mines_))
+	{
+		excluded_indices.assign(neighbour_indices.begin(), neighbour_indices.end());
+	}
+
+	if (size_ - 1 >= static_cast<std::size_t>(mines_))
+	{
+		excluded_indices.push_back(safe_index);
+	}
+
+	PlaceMines(seed, excluded_indices);
+}
+
+void Board::PlaceMines(std::uint64_t seed, const std::vector<std::size_t>& excluded_indices)
+{
+	seed_ = seed;
+	mines_placed_ = true;
+	layout_id_ = NextLayoutId();
+	mine_plane_.Clear();
+
+	/* Excluding too many cells leaves fewer mines than asked for, the counts follow what was placed. */
+	CounterRng rng(seed);
+	mines_ = static_cast<int>(SampleMines(mine_plane_, mines_, excluded_indices, rng));
+	covered_safe_cells_ = width_ * height_ - mines_;
+
+	CountNeighbourMines(mine_plane_, width_, height_, vicinity_plane_);
+}
+
+BoardState Board::Reveal(std::size_t start_index)
+{
+	revealed_cells_.clear();
+	RevealCell(start_index);
+
+	return state_;
+}
+
+BoardState Board::Reveal(int x, int y)
+{
+	return Contains(x, y) ? Reveal(GetIndex(x, y)) : state_;
+}
+
+bool Board::ToggleFlag(std::size_t index)
+{
+	if (state_ != BoardState::PLAYING || uncovered_plane_.Get(index))
+	{
+		return false;
+	}
+
+	flag_plane_.Flip(index);
+	flags_placed_ += flag_plane_.Get(index) ? 1 : -1;
+
+	return true;
+}
+
+bool Board::ToggleFlag(int x, int y)
+{
+	return Contains(x, y) && ToggleFlag(GetIndex(x, y));
+}
+
+BoardState Board::Chord(std::size_t start_index)
+{
+	if (state_ != BoardState::PLAYING || !uncovered_plane_.Get(start_index))
+	{
+		return state_;
+	}
+
+	const NeighbourIndices neighbour_indices = GetNeighboursIndices(start_index);
+
+	const int flagged_mines = std::count_if(neighbour_indices.begin(), neighbour_indices.end(), [this](std::size_t neighbour_index)
+	{
+		return flag_plane_.Get(neighbour_index);
+	});
+
+	if (flagged_mines != vicinity_plane_.Get(start_index))
+	{
+		return state_;
+	}
+
+	revealed_cells_.clear();
+
+	for (std::size_t neighbour_index : neighbour_indices)
+	{
+		RevealCell(neighbour_index);
+
+		if (state_ != BoardState::PLAYING)
+		{
+			break;
+		}
+	}
+
+	return state_;
+}
+
+BoardState Board::Chord(int x, int y)
+{
+	return Contains(x, y) ? Chord(GetIndex(x, y)) : state_;
+}
+
+void Board::RevealCell(std::size_t index)
+{
+	if (state_ != BoardState::PLAYING || uncovered_plane_.Get(index) || flag_plane_.Get(index))
+	{
+		return;
+	}
+
+	if (mine_plane_.Get(index))
+	{
+		Explode(index);
+		return;
+	}
+
+	UncoverSafeCell(index);
+
+	if (vicinity_plane_.Get(index) == 0)
+	{
+		RevealZeroRegion(index);
+	}
+
+	if (covered_safe_cells_ == 0)
+	{
+		Win();
+	}
+}
+
+void Board::UncoverSafeCell(std::size_t index)
+{
+	uncovered_plane_.Set(index);
+	revealed_cells_.push_back(index);
+	--covered_safe_cells_;
+}
+
+/* Scanline flood fill over the 8-connected region of empty cells around start_index, which must already be 
+ * uncovered. Cells are uncovered when they are pushed, so nothing is visited twice. Every span of empty cells 
+ * is pushed once and scans the row above and below it, one cell wider on each side. */
+void Board::RevealZeroRegion(std::size_t start_index)
+{
+	span_stack_.clear();
+	PushZeroSpan(static_cast<int>(start_index % width_), static_cast<int>(start_index / width_));
+
+	while (!span_stack_.empty())
+	{
+		const Span span = span_stack_.back();
+		span_stack_.pop_back();
+
+		const int x_begin = std::max(span.x0_ - 1, 0);
+		const int x_end = std::min(span.x1_ + 1, width_ - 1);
+
+		for (int y = span.y_ - 1; y <= span.y_ + 1; y += 2)
+		{
+			if (y < 0 || y >= height_)
+			{
+				continue;
+			}
+
+			for (int x = x_begin; x <= x_end; ++x)
+			{
+				const std::size_t index = GetIndex(x, y);
+
+				if (uncovered_plane_.Get(index) || flag_plane_.Get(index))
+				{
+					continue;
+				}
+
+				UncoverSafeCell(index);
+
+				if (vicinity_plane_.Get(index) == 0)
+				{
+					PushZeroSpan(x, y);
+				}
+			}
+		}
+	}
+}
+
+/* Grows the empty cell at (x, y) into a horizontal span of empty cells, uncovering it and the numbered cells at both ends. */
+void Board::PushZeroSpan(int x, int y)
+{
+	const std::size_t row_index = GetIndex(0, y);
+
+	int x0 = x;
+	int x1 = x;
+
+	while (x0 > 0)
+	{
+		const std::size_t index = row_index + x0 - 1;
+
+		if (uncovered_plane_.Get(index) || flag_plane_.Get(index))
+		{
+			break;
+		}
+
+		UncoverSafeCell(index);
+
+		if (vicinity_plane_.Get(index) != 0)
+		{
+			break;
+		}
+
+		--x0;
+	}
+
+	while (x1 < width_ - 1)
+	{
+		const std::size_t index = row_index + x1 + 1;
+
+		if (uncovered_plane_.Get(index) || flag_plane_.Get(index))
+		{
+			break;
+		}
+
+		UncoverSafeCell(index);
+
+		if (vicinity_plane_.Get(index) != 0)
+		{
+			break;
+		}
+
+		++x1;
+	}
+
+	span_stack_.push_back({ y, x0, x1 });
+}
+
+void Board::Explode(std::size_t index)
+{
+	state_ = BoardState::LOST;
+	exploded_index_ = index;
+
+	const std::uint64_t* mine_words = mine_plane_.GetWords();
+	const std::uint64_t* flag_words = flag_plane_.GetWords();
+	std::uint64_t* uncovered_words = uncovered_plane_.GetWords();
+
+	for (std::size_t i = 0; i < uncovered_plane_.GetWordCount(); ++i)
+	{
+		uncovered_words[i] |= mine_words[i] & ~flag_words[i];
+	}
+}
+
+void Board::Win()
+{
+	state_ = BoardState::WON;
+	flags_placed_ = mines_;
+
+	const std::uint64_t* mine_words = mine_plane_.GetWords();
+	std::uint64_t* flag_words = flag_plane_.GetWords();
+
+	for (std::size_t i = 0; i < flag_plane_.GetWordCount(); ++i)
+	{
+		flag_words[i] |= mine_words[i];
+	}
+}
+
+bool Board::AreMinesPlaced() const
+{
+	return mines_placed_;
+}
+
+std::uint64_t Board::GetSeed() const
+{
+	return seed_;
+}
+
+std::uint64_t Board::GetLayoutId() const
+{
+	return layout_id_;
+}
+
+int Board::GetWidth() const
+{
+	return width_;
+}
+
+int Board::GetHeight() const
+{
+	return height_;
+}
+
+int Board::GetMines() const
+{
+	return mines_;
+}
+
+int Board::GetMinesLeft() const
+{
+	return mines_ - flags_placed_;
+}
+
+int Board::GetFlagsPlaced() const
+{
+	return flags_placed_;
+}
+
+int Board::GetCoveredSafeCells() const
+{
+	return covered_safe_cells_;
+}
+
+std::size_t Board::GetSize() const
+{
+	return size_;
+}
+
+BoardState Board::GetState() const
+{
+	return state_;
+}
+
+const std::vector<std::size_t>& Board::GetRevealedCells() const
+{
+	return revealed_cells_;
+}
+
+bool Board::Contains(int x, int y) const
+{
+	return x >= 0 && x < width_ && y >= 0 && y < height_;
+}
+
+std::size_t Board::GetIndex(int x, int y) const
+{
+	return static_cast<std::size_t>(y) * static_cast<std::size_t>(width_) + static_cast<std::size_t>(x);
+}
+
+bool Board::IsMine(std::size_t index) const
+{
+	return mine_plane_.Get(index);
+}
+
+bool Board::IsMineExploded(std::size_t index) const
+{
+	return index == exploded_index_;
+}
+
+bool Board::IsUncovered(std::size_t index) const
+{
+	return uncovered_plane_.Get(index);
+}
+
+bool Board::IsFlagged(std::size_t index) const
+{
+	return flag_plane_.Get(index);
+}
+
+bool Board::IsPressed(std::size_t index) const
+{
+	return pressed_plane_.Get(index);
+}
+
+void Board::SetPressed(std::size_t index, bool pressed)
+{
+	pressed_plane_.Assign(index, pressed);
+}
+
+void Board::ClearPressed()
+{
+	pressed_plane_.Clear();
+}
+
+int Board::GetMinesInVicinity(std::size_t index) const
+{
+	return vicinity_plane_.Get(index);
+}
+
+const BitPlane& Board::GetUncoveredPlane() const
+{
+	return uncovered_plane_;
+}
+
+const BitPlane& Board::GetFlagPlane() const
+{
+	return flag_plane_;
+}
+
+const BitPlane& Board::GetPressedPlane() const
+{
+	return pressed_plane_;
+}
+
+std::size_t Board::GetMemoryUsage() const
+{
+	return mine_plane_.GetMemoryUsage() + uncovered_plane_.GetMemoryUsage() + flag_plane_.GetMemoryUsage() + 
+		pressed_plane_.GetMemoryUsage() + vicinity_plane_.GetMemoryUsage();
+}
+
+NeighbourIndices Board::GetNeighboursIndices(std::size_t cell_index) const
+{
+	NeighbourIndices result_indices;
+
+	const std::size_t width = static_cast<std::size_t>(width_);
+	const std::size_t x = cell_index % width;
+	const std::size_t y = cell_index / width;
+
+	const bool left_cell_available = x > 0;
+	const bool right_cell_available = x + 1 < width;
+	const bool upper_cell_available = y > 0;
+	const bool lower_cell_available = y + 1 < static_cast<std::size_t>(height_);
+
+	/* Interior cells take all eight precomputed offsets without further checks. */
+	if (left_cell_available && right_cell_available && upper_cell_available && lower_cell_available)
+	{
+		for (std::ptrdiff_t offset : neighbour_offsets_)
+		{
+			result_indices.Push(cell_index + offset);
+		}
+
+		return result_indices;
+	}
+
+	if (upper_cell_available)
+	{
+		if (left_cell_available)
+		{
+			result_indices.Push(cell_index - width - 1);
+		}
+
+		result_indices.Push(cell_index - width);
+
+		if (right_cell_available)
+		{
+			result_indices.Push(cell_index - width + 1);
+		}
+	}
+
+	if (left_cell_available)
+	{
+		result_indices.Push(cell_index - 1);
+	}
+
+	if (right_cell_available)
+	{
+		result_indices.Push(cell_index + 1);
+	}
+
+	if (lower_cell_available)
+	{
+		if (left_cell_available)
+		{
+			result_indices.Push(cell_index + width - 1);
+		}
+
+		result_indices.Push(cell_index + width);
+
+		if (right_cell_available)
+		{
+			result_indices.Push(cell_index + width + 1);
+		}
+	}
+
+	return result_indices;
+}
+
+BoardImage Board::GetImage() const
+{
+	return { width_, height_, mines_, flags_placed_, covered_safe_cells_, mines_placed_, seed_, state_, exploded_index_, 
+		mine_plane_.GetWords(), uncovered_plane_.GetWords(), flag_plane_.GetWords(), vicinity_plane_.GetBytes() };
+}
+
+void Board::Restore(const BoardImage& image)
+{
+	Reset(image.width_, image.height_, image.mines_);
+
+	flags_placed_ = image.flags_placed_;
+	covered_safe_cells_ = image.covered_safe_cells_;
+	mines_placed_ = image.mines_placed_;
+	seed_ = image.seed_;
+	state_ = image.state_;
+	exploded_index_ = image.exploded_index_;
+
+	std::copy(image.mine_words_, image.mine_words_ + mine_plane_.GetWordCount(), mine_plane_.GetWords());
+	std::copy(image.uncovered_words_, image.uncovered_words_ + uncovered_plane_.GetWordCount(), uncovered_plane_.GetWords());
+	std::copy(image.flag_words_, image.flag_words_ + flag_plane_.GetWordCount(), flag_plane_.GetWords());
+	std::copy(image.vicinity_bytes_, image.vicinity_bytes_ + (size_ + 1) / 2, vicinity_plane_.GetBytes());
+
+	if (size_ != 0)
+	{
+		mine_plane_.GetWords()[mine_plane_.GetWordCount() - 1] &= mine_plane_.GetTailMask();
+		uncovered_plane_.GetWords()[uncovered_plane_.GetWordCount() - 1] &= uncovered_plane_.GetTailMask();
+		flag_plane_.GetWords()[flag_plane_.GetWordCount() - 1] &= flag_plane_.GetTailMask();
+	}
+}
@@ -0,0 +1,65 @@
+#include "BoardGenerator.hpp"
+#include "Random.hpp"
+#include "Solver.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+std::uint64_t GetCandidateSeed(std::uint64_t seed, std::size_t candidate)
+{
+	return CounterRng(seed, candidate)();
+}
+
+bool GenerateNoGuessBoard(Board& board, std::uint64_t seed, std::size_t first_click_index, ThreadPool& thread_pool, std::size_t max_candidates)
+{
+	std::atomic<std::size_t> next_candidate(0);
+	std::atomic<std::size_t> best_candidate(max_candidates);
+
+	const int width = board.GetWidth();
+	const int height = board.GetHeight();
+	const int mines = board.GetMines();
+
+	ThreadPool::TaskGroup task_group;
+
+	for (std::size_t worker = 0; worker < thread_pool.GetThreadCount(); ++worker)
+	{
+		thread_pool.Submit(task_group, [&, width, height, mines]
+		{
+			Board candidate_board(width, height, mines);
+			Solver solver;
+
+			while (true)
+			{
+				const std::size_t candidate = next_candidate.fetch_add(1, std::memory_order_relaxed);
+
+				if (candidate >= best_candidate.load(std::memory_order_relaxed))
+				{
+					return;
+				}
+
+				candidate_board.Reset();
+				candidate_board.PlaceMines(GetCandidateSeed(seed, candidate), first_click_index);
+				candidate_board.Reveal(first_click_index);
+
+				if (solver.Solve(candidate_board))
+				{
+					std::size_t best = best_candidate.load(std::memory_order_relaxed);
+
+					while (candidate < best && !best_candidate.compare_exchange_weak(best, candidate, std::memory_order_relaxed))
+					{
+					}
+
+					return;
+				}
+			}
+		});
+	}
+
+	thread_pool.Wait(task_group);
+
+	const std::size_t candidate = best_candidate.load();
+	board.PlaceMines(GetCandidateSeed(seed, candidate < max_candidates ? candidate : 0), first_click_index);
+
+	return candidate < max_candidates;
+}
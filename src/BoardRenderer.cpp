@@ -0,0 +1,365 @@
+#include "BoardRenderer.hpp"
+#include "Cell.hpp"
+#include "Game.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cstdint>
+
+BoardRenderer::BoardRenderer(const Game* game) : 
+	game_(game), 
+	target_(nullptr), 
+	target_width_(0), 
+	target_height_(0), 
+	redraw_all_(true), 
+	x0_(0), 
+	y0_(0), 
+	x1_(0), 
+	y1_(0), 
+	cell_size_(0), 
+	origin_x_(0), 
+	origin_y_(0), 
+	rendered_game_over_(false), 
+	rendered_hint_visible_(false), 
+	rendered_hint_index_(0)
+{
+}
+
+BoardRenderer::~BoardRenderer()
+{
+	if (target_ != nullptr)
+	{
+		SDL_DestroyTexture(target_);
+		target_ = nullptr;
+	}
+}
+
+void BoardRenderer::Invalidate()
+{
+	redraw_all_ = true;
+}
+
+void BoardRenderer::ReleaseTarget()
+{
+	if (target_ != nullptr)
+	{
+		SDL_DestroyTexture(target_);
+		target_ = nullptr;
+	}
+
+	target_width_ = 0;
+	target_height_ = 0;
+	redraw_all_ = true;
+}
+
+void BoardRenderer::MarkDirty(std::size_t index)
+{
+	if (IsVisible(index))
+	{
+		dirty_cells_.push_back(index);
+	}
+}
+
+bool BoardRenderer::UpdateTarget()
+{
+	const int width = game_->camera_.GetVisibleWidth();
+	const int height = game_->camera_.GetVisibleHeight();
+
+	if (width == target_width_ && height == target_height_)
+	{
+		return target_ != nullptr;
+	}
+
+	if (target_ != nullptr)
+	{
+		SDL_DestroyTexture(target_);
+		target_ = nullptr;
+	}
+
+	target_width_ = width;
+	target_height_ = height;
+	redraw_all_ = true;
+
+	if (!SDL_RenderTargetSupported(game_->renderer_))
+	{
+		return false;
+	}
+
+	target_ = SDL_CreateTexture(game_->renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+
+	if (target_ == nullptr)
+	{
+		printf("Unable to create the board render target! SDL Error: %s\n", SDL_GetError());
+		return false;
+	}
+
+	render_stats::CountTextureUpload();
+	return true;
+}
+
+void BoardRenderer::UpdateVisibleCells()
+{
+	const Camera& camera = game_->camera_;
+
+	int x0 = 0;
+	int y0 = 0;
+	int x1 = 0;
+	int y1 = 0;
+	camera.GetVisibleCells(&x0, &y0, &x1, &y1);
+
+	if (x0 == x0_ && y0 == y0_ && x1 == x1_ && y1 == y1_ && camera.GetCellSize() == cell_size_ 
+		&& camera.GetOriginX() == origin_x_ && camera.GetOriginY() == origin_y_)
+	{
+		return;
+	}
+
+	const std::size_t cell_count = static_cast<std::size_t>(x1 - x0) * (y1 - y0);
+
+	x0_ = x0;
+	y0_ = y0;
+	x1_ = x1;
+	y1_ = y1;
+	cell_size_ = camera.GetCellSize();
+	origin_x_ = camera.GetOriginX();
+	origin_y_ = camera.GetOriginY();
+	redraw_all_ = true;
+
+	if (vertices_.size() != cell_count * Cell::quad_count * 4)
+	{
+		vertices_.resize(cell_count * Cell::quad_count * 4);
+		indices_.clear();
+
+		for (std::size_t slot = 0; slot < cell_count; ++slot)
+		{
+			AppendIndices(slot, indices_);
+		}
+	}
+}
+
+void BoardRenderer::GetVisibleWordRange(std::size_t* first_word, std::size_t* last_word) const
+{
+	const std::size_t width = game_->board_.GetWidth();
+
+	*first_word = y0_ * width / 64;
+	*last_word = std::min(rendered_uncovered_plane_.GetWordCount(), (y1_ * width + 63) / 64);
+}
+
+void BoardRenderer::CollectDirtyCells()
+{
+	const Board& board = game_->board_;
+
+	if (rendered_uncovered_plane_.GetSize() != board.GetSize() || rendered_game_over_ != game_->game_over_)
+	{
+		redraw_all_ = true;
+		return;
+	}
+
+	const std::uint64_t* uncovered_words = board.GetUncoveredPlane().GetWords();
+	const std::uint64_t* flag_words = board.GetFlagPlane().GetWords();
+	const std::uint64_t* pressed_words = board.GetPressedPlane().GetWords();
+	const std::uint64_t* rendered_uncovered_words = rendered_uncovered_plane_.GetWords();
+	const std::uint64_t* rendered_flag_words = rendered_flag_plane_.GetWords();
+	const std::uint64_t* rendered_pressed_words = rendered_pressed_plane_.GetWords();
+
+	std::size_t first_word = 0;
+	std::size_t last_word = 0;
+	GetVisibleWordRange(&first_word, &last_word);
+
+	for (std::size_t i = first_word; i < last_word; ++i)
+	{
+		std::uint64_t changed = (uncovered_words[i] ^ rendered_uncovered_words[i]) | (flag_words[i] ^ rendered_flag_words[i]) | (pressed_words[i] ^ rendered_pressed_words[i]);
+
+		while (changed != 0)
+		{
+			MarkDirty(i * 64 + __builtin_ctzll(changed));
+			changed &= changed - 1;
+		}
+	}
+
+	if (rendered_hint_visible_ != game_->hint_visible_ || rendered_hint_index_ != game_->hint_index_)
+	{
+		if (rendered_hint_visible_)
+		{
+			MarkDirty(rendered_hint_index_);
+		}
+
+		if (game_->hint_visible_)
+		{
+			MarkDirty(game_->hint_index_);
+		}
+	}
+}
+
+void BoardRenderer::RememberRenderedState()
+{
+	const Board& board = game_->board_;
+
+	if (rendered_uncovered_plane_.GetSize() != board.GetSize())
+	{
+		rendered_uncovered_plane_.Reset(board.GetSize());
+		rendered_flag_plane_.Reset(board.GetSize());
+		rendered_pressed_plane_.Reset(board.GetSize());
+	}
+
+	/* Only the visible rows are kept current. The rest are never compared before the camera moves, which 
+	 * redraws the whole view anyway. */
+	std::size_t first_word = 0;
+	std::size_t last_word = 0;
+	GetVisibleWordRange(&first_word, &last_word);
+
+	const std::uint64_t* uncovered_words = board.GetUncoveredPlane().GetWords();
+	const std::uint64_t* flag_words = board.GetFlagPlane().GetWords();
+	const std::uint64_t* pressed_words = board.GetPressedPlane().GetWords();
+
+	std::copy(uncovered_words + first_word, uncovered_words + last_word, rendered_uncovered_plane_.GetWords() + first_word);
+	std::copy(flag_words + first_word, flag_words + last_word, rendered_flag_plane_.GetWords() + first_word);
+	std::copy(pressed_words + first_word, pressed_words + last_word, rendered_pressed_plane_.GetWords() + first_word);
+
+	rendered_game_over_ = game_->game_over_;
+	rendered_hint_visible_ = game_->hint_visible_;
+	rendered_hint_index_ = game_->hint_index_;
+}
+
+bool BoardRenderer::IsVisible(std::size_t index) const
+{
+	if (index >= game_->board_.GetSize())
+	{
+		return false;
+	}
+
+	const int x = static_cast<int>(index % game_->board_.GetWidth());
+	const int y = static_cast<int>(index / game_->board_.GetWidth());
+
+	return x >= x0_ && x < x1_ && y >= y0_ && y < y1_;
+}
+
+std::size_t BoardRenderer::GetSlot(std::size_t index) const
+{
+	const int x = static_cast<int>(index % game_->board_.GetWidth());
+	const int y = static_cast<int>(index / game_->board_.GetWidth());
+
+	return static_cast<std::size_t>(y - y0_) * (x1_ - x0_) + (x - x0_);
+}
+
+void BoardRenderer::WriteCell(std::size_t index)
+{
+	Cell(game_, index).WriteVertices(&vertices_[GetSlot(index) * Cell::quad_count * 4]);
+}
+
+void BoardRenderer::AppendIndices(std::size_t slot, std::vector<int>& indices) const
+{
+	const int first_vertex = static_cast<int>(slot) * Cell::quad_count * 4;
+
+	for (int quad = 0; quad < Cell::quad_count; ++quad)
+	{
+		const int quad_vertex = first_vertex + quad * 4;
+
+		indices.insert(indices.end(), { quad_vertex, quad_vertex + 1, quad_vertex + 2, quad_vertex, quad_vertex + 2, quad_vertex + 3 });
+	}
+}
+
+void BoardRenderer::SubmitGeometry(const std::vector<int>& indices)
+{
+	if (indices.empty())
+	{
+		return;
+	}
+
+	SDL_RenderGeometry(game_->renderer_, game_->sprite_atlas_->GetTexture()->texture_, vertices_.data(), static_cast<int>(vertices_.size()), 
+		indices.data(), static_cast<int>(indices.size()));
+	render_stats::CountDrawCall();
+}
+
+void BoardRenderer::RenderHint()
+{
+	if (game_->hint_visible_ && IsVisible(game_->hint_index_))
+	{
+		Cell(game_, game_->hint_index_).RenderHint();
+	}
+}
+
+void BoardRenderer::Render()
+{
+	PROFILE_ZONE("BoardRenderer::Render");
+
+	SDL_Renderer* renderer = game_->renderer_;
+
+	UpdateVisibleCells();
+
+	const bool has_target = UpdateTarget();
+
+	if (!redraw_all_)
+	{
+		CollectDirtyCells();
+	}
+
+	const bool changed = redraw_all_ || !dirty_cells_.empty();
+
+	if (redraw_all_)
+	{
+		const std::size_t width = game_->board_.GetWidth();
+
+		for (int y = y0_; y < y1_; ++y)
+		{
+			for (int x = x0_; x < x1_; ++x)
+			{
+				WriteCell(static_cast<std::size_t>(y) * width + x);
+			}
+		}
+	}
+	else
+	{
+		for (std::size_t index : dirty_cells_)
+		{
+			WriteCell(index);
+		}
+	}
+
+	if (!has_target)
+	{
+		SubmitGeometry(indices_);
+		RenderHint();
+	}
+	else if (changed)
+	{
+		/* The window's viewport is restored when the target is reset. */
+		SDL_SetRenderTarget(renderer, target_);
+
+		if (redraw_all_)
+		{
+			SubmitGeometry(indices_);
+		}
+		else
+		{
+			dirty_indices_.clear();
+
+			for (std::size_t index : dirty_cells_)
+			{
+				AppendIndices(GetSlot(index), dirty_indices_);
+			}
+
+			SubmitGeometry(dirty_indices_);
+		}
+
+		RenderHint();
+
+		SDL_SetRenderTarget(renderer, nullptr);
+	}
+
+	if (changed)
+	{
+		redraw_all_ = false;
+		dirty_cells_.clear();
+		RememberRenderedState();
+	}
+
+	if (has_target)
+	{
+		const SDL_Rect target_rect = { 0, 0, target_width_, target_height_ };
+		SDL_RenderCopy(renderer, target_, nullptr, &target_rect);
+		render_stats::CountDrawCall();
+	}
+}
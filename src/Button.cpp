@@ -7,51 +7,31 @@ Button::Button(Game* game, TTF_Font* font, const std::string& text, int x, int y
 	game_(game), 
 	font_(font), 
 	top_left_({ x, y }), 
-	button_texture_(std::make_unique<Texture>()), 
+	normal_texture_(std::make_unique<Texture>()), 
+	highlighted_texture_(std::make_unique<Texture>()), 
+	disabled_texture_(std::make_unique<Texture>()), 
 	button_text_(text), 
 	highlighted_(false), 
-	redraw_(false), 
 	enabled_(true)
 {
-	UpdateButtonFlags();
-	LoadText();
+	LoadTextures();
 }
 
 Button::~Button()
 {
 }
 
-void Button::UpdateButtonFlags()
+void Button::LoadTextures()
 {
-	const bool mouse_overlaps_button = MouseOverlapsButton();
+	const SDL_Color normal_color = { 0x00, 0x00, 0x00, 0x00 };
+	const SDL_Color highlighted_color = { 0xFF, 0x00, 0x00, 0xFF };
+	const SDL_Color disabled_color = { 0x00, 0x00, 0x00, 0x19 };
 
-	if (highlighted_ != mouse_overlaps_button)
-	{
-		highlighted_ = mouse_overlaps_button;
-		redraw_ = enabled_;
-	}
+	normal_texture_->LoadFromText(game_->renderer_, font_, button_text_.c_str(), normal_color, -1);
+	highlighted_texture_->LoadFromText(game_->renderer_, font_, button_text_.c_str(), highlighted_color, -1);
+	disabled_texture_->LoadFromText(game_->renderer_, font_, button_text_.c_str(), disabled_color, -1);
 }
 
-void Button::LoadText()
-{
-	SDL_Color text_color = { 0x00, 0x00, 0x00, 0x00 };
-
-	if (highlighted_)
-	{
-		text_color = { 0xFF, 0x00, 0x00, 0xFF };
-	}
-
-	if (!enabled_)
-	{
-		text_color = { 0x00, 0x00, 0x00, 0x19 };
-	}
-
-	button_texture_->FreeTexture();
-	button_texture_->LoadFromText(game_->renderer_, font_, button_text_.c_str(), text_color, -1);
-	redraw_ = false;
-}
-
-
 void Button::SetPosition(int x, int y)
 {
 	top_left_.x = x;
@@ -60,42 +40,51 @@ void Button::SetPosition(int x, int y)
 
 void Button::SetText(const std::string& text)
 {
-	button_text_ = text;
+	if (text != button_text_)
+	{
+		button_text_ = text;
+		LoadTextures();
+	}
 }
 
-Texture* Button::GetTexture()
+void Button::SetEnabled(bool enabled)
 {
-	return button_texture_.get();
+	enabled_ = enabled;
 }
 
+Texture* Button::GetTexture()
+{
+	return normal_texture_.get();
+}
 
-void Button::HandleEvent(SDL_Event* e)
+void Button::HandleEvent(const SDL_Event* e)
 {
 	if (e->type == SDL_MOUSEMOTION)
 	{
-		UpdateButtonFlags();
+		highlighted_ = ContainsPoint(e->motion.x, e->motion.y);
 	}
 }
 
-void Button::Tick()
+void Button::Render()
 {
-	if (redraw_)
+	Texture* texture = normal_texture_.get();
+
+	if (!enabled_)
 	{
-		LoadText();
+		texture = disabled_texture_.get();
+	}
+	else if (highlighted_)
+	{
+		texture = highlighted_texture_.get();
 	}
-}
 
-void Button::Render()
-{
-	button_texture_->Render(game_->renderer_, top_left_.x, top_left_.y);
+	texture->Render(game_->renderer_, top_left_.x, top_left_.y);
 }
 
-bool Button::MouseOverlapsButton()
+bool Button::ContainsPoint(int x, int y) const
 {
-	SDL_Point mouse_position;
-	SDL_GetMouseState(&mouse_position.x, &mouse_position.y);
-	
-	SDL_Rect button_bounding_box = { top_left_.x, top_left_.y, button_texture_->width_, button_texture_->height_ };
+	const SDL_Point point = { x, y };
+	const SDL_Rect button_bounding_box = { top_left_.x, top_left_.y, normal_texture_->width_, normal_texture_->height_ };
 
-	return SDL_PointInRect(&mouse_position, &button_bounding_box);
-}
\ No newline at end of file
+	return SDL_PointInRect(&point, &button_bounding_box);
+}
@@ -0,0 +1,139 @@
+#include "Camera.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+	constexpr std::array<int, 8> cell_sizes = { 4, 8, 12, 16, 24, 32, 48, 64 };
+	constexpr int default_zoom_level = 5;
+}
+
+Camera::Camera() : 
+	board_width_(0), 
+	board_height_(0), 
+	view_width_(0), 
+	view_height_(0), 
+	zoom_level_(default_zoom_level), 
+	origin_x_(0), 
+	origin_y_(0)
+{
+}
+
+Camera::~Camera()
+{
+}
+
+void Camera::Clamp()
+{
+	const int max_origin_x = std::max(0, board_width_ * GetCellSize() - view_width_);
+	const int max_origin_y = std::max(0, board_height_ * GetCellSize() - view_height_);
+
+	origin_x_ = std::clamp(origin_x_, 0, max_origin_x);
+	origin_y_ = std::clamp(origin_y_, 0, max_origin_y);
+}
+
+void Camera::Reset(int board_width, int board_height, int view_width, int view_height)
+{
+	board_width_ = board_width;
+	board_height_ = board_height;
+	view_width_ = view_width;
+	view_height_ = view_height;
+	zoom_level_ = default_zoom_level;
+	origin_x_ = 0;
+	origin_y_ = 0;
+}
+
+void Camera::Pan(int dx, int dy)
+{
+	origin_x_ += dx;
+	origin_y_ += dy;
+
+	Clamp();
+}
+
+void Camera::Zoom(int steps, int anchor_x, int anchor_y)
+{
+	const int new_zoom_level = std::clamp(zoom_level_ + steps, 0, static_cast<int>(cell_sizes.size()) - 1);
+
+	if (new_zoom_level == zoom_level_)
+	{
+		return;
+	}
+
+	const int old_cell_size = GetCellSize();
+	const int new_cell_size = cell_sizes[new_zoom_level];
+
+	/* 64-bit, a 1000x1000 board at the largest zoom is 64000 pixels wide. */
+	const long long anchor_board_x = static_cast<long long>(origin_x_ + anchor_x) * new_cell_size / old_cell_size;
+	const long long anchor_board_y = static_cast<long long>(origin_y_ + anchor_y) * new_cell_size / old_cell_size;
+
+	zoom_level_ = new_zoom_level;
+	origin_x_ = static_cast<int>(anchor_board_x - anchor_x);
+	origin_y_ = static_cast<int>(anchor_board_y - anchor_y);
+
+	Clamp();
+}
+
+void Camera::CenterOn(int x, int y)
+{
+	origin_x_ = x * GetCellSize() + GetCellSize() / 2 - view_width_ / 2;
+	origin_y_ = y * GetCellSize() + GetCellSize() / 2 - view_height_ / 2;
+
+	Clamp();
+}
+
+int Camera::GetCellSize() const
+{
+	return cell_sizes[zoom_level_];
+}
+
+int Camera::GetOriginX() const
+{
+	return origin_x_;
+}
+
+int Camera::GetOriginY() const
+{
+	return origin_y_;
+}
+
+int Camera::GetVisibleWidth() const
+{
+	return std::min(view_width_, board_width_ * GetCellSize());
+}
+
+int Camera::GetVisibleHeight() const
+{
+	return std::min(view_height_, board_height_ * GetCellSize());
+}
+
+void Camera::GetVisibleCells(int* x0, int* y0, int* x1, int* y1) const
+{
+	const int cell_size = GetCellSize();
+
+	*x0 = origin_x_ / cell_size;
+	*y0 = origin_y_ / cell_size;
+	*x1 = std::min(board_width_, (origin_x_ + GetVisibleWidth() + cell_size - 1) / cell_size);
+	*y1 = std::min(board_height_, (origin_y_ + GetVisibleHeight() + cell_size - 1) / cell_size);
+}
+
+SDL_Rect Camera::GetCellRect(int x, int y) const
+{
+	const int cell_size = GetCellSize();
+
+	return { x * cell_size - origin_x_, y * cell_size - origin_y_, cell_size, cell_size };
+}
+
+bool Camera::GetCellAt(int view_x, int view_y, int* x, int* y) const
+{
+	if (view_x < 0 || view_x >= GetVisibleWidth() || view_y < 0 || view_y >= GetVisibleHeight())
+	{
+		return false;
+	}
+
+	*x = (origin_x_ + view_x) / GetCellSize();
+	*y = (origin_y_ + view_y) / GetCellSize();
+
+	return *x < board_width_ && *y < board_height_;
+}
@@ -1,17 +1,12 @@
 #include "Cell.hpp"
 #include "Game.hpp"
+#include "RenderStats.hpp"
 
 #include <iostream>
 
-Cell::Cell(Game* game) : 
+Cell::Cell(const Game* game, std::size_t index) : 
 	game_(game), 
-	render_cell_(true), 
-	flag_(false), 
-	mine_(false), 
-	mine_exploded_(false), 
-	uncovered_(false), 
-	mines_in_vicinity_(0), 
-	mines_in_vicinity_texture_(nullptr)
+	index_(index)
 {
 }
 
@@ -19,62 +14,124 @@ Cell::~Cell()
 {
 }
 
-void Cell::Uncover()
+SDL_Rect Cell::GetRect() const
 {
-	render_cell_ = false;
-	uncovered_ = true;
-}
+	const std::size_t width = game_->board_.GetWidth();
 
-void Cell::HandleEvents()
-{
-}
-	
-void Cell::Tick()
-{
+	return game_->camera_.GetCellRect(static_cast<int>(index_ % width), static_cast<int>(index_ / width));
 }
 
-void Cell::Render() const
+void Cell::WriteVertices(SDL_Vertex* vertices) const
 {
-	SDL_Rect clip;
-	clip.y = 0;
-	clip.w = 32;
-	clip.h = 32;
+	const Board& board = game_->board_;
+	const SpriteAtlas& atlas = *game_->sprite_atlas_;
+	const SDL_Rect rect = GetRect();
 
-	if (render_cell_)
-	{
-		clip.x = 0;
-		
-		game_->sprites_texture_->Render(game_->renderer_, rect_.x, rect_.y, 1.0, &clip);
+	const SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+	const SDL_Color grid_color = { 0x80, 0x80, 0x80, 0xFF };
+	const SDL_Color background_color = { 0xC6, 0xC6, 0xC6, 0xFF };
+	const SDL_Color exploded_color = { 0xFF, 0x00, 0x00, 0xFF };
+	const SDL_Color wrong_flag_color = { 0xFE, 0xA0, 0xA0, 0xFF };
 
-		if (flag_)
-		{
-			if (game_->game_over_ && !mine_)
-			{
-				SDL_SetRenderDrawColor(game_->renderer_, 0xFE, 0xA0, 0xA0, 0xFF);
-				SDL_RenderFillRect(game_->renderer_, &rect_);
-			}
+	SDL_Vertex* sprite_vertices = vertices + 8;
+	SDL_Vertex* top_vertices = vertices + 12;
 
-			clip.x = 64;
-			game_->sprites_texture_->Render(game_->renderer_, rect_.x, rect_.y, 1.0, &clip);
+	/* Grid line pixels belong to the cell right of or below them. */
+	const std::size_t width = board.GetWidth();
+	SDL_Rect inner_rect = rect;
 
-		}
+	if (index_ % width > 0)
+	{
+		++inner_rect.x;
+		--inner_rect.w;
+	}
+
+	if (index_ >= width)
+	{
+		++inner_rect.y;
+		--inner_rect.h;
 	}
-	else if (uncovered_)
+
+	const bool exploded = board.IsUncovered(index_) && board.IsMineExploded(index_);
+
+	atlas.WriteSolidQuad(vertices, rect, exploded ? exploded_color : grid_color);
+	atlas.WriteSolidQuad(vertices + 4, inner_rect, exploded ? exploded_color : background_color);
+
+	if (!board.IsUncovered(index_))
 	{
-		if (mine_)
+		if (board.IsPressed(index_))
 		{
-			if (mine_exploded_)
+			atlas.WriteEmptyQuad(sprite_vertices);
+			atlas.WriteEmptyQuad(top_vertices);
+		}
+		else if (board.IsFlagged(index_))
+		{
+			if (game_->game_over_ && !board.IsMine(index_))
+			{
+				atlas.WriteSolidQuad(sprite_vertices, rect, wrong_flag_color);
+			}
+			else
 			{
-				SDL_SetRenderDrawColor(game_->renderer_, 0xFF, 0x00, 0x00, 0xFF);
-				SDL_RenderFillRect(game_->renderer_, &rect_);
+				atlas.WriteQuad(sprite_vertices, rect, atlas.GetCoveredRect(), white);
 			}
 
-			clip.x = 32;
-			game_->sprites_texture_->Render(game_->renderer_, rect_.x, rect_.y, 1.0, &clip);
+			atlas.WriteQuad(top_vertices, rect, atlas.GetFlagRect(), white);
 		}
-		else if (mines_in_vicinity_ != 0)
+		else
 		{
-			game_->mine_numbers_textures_[mines_in_vicinity_ - 1]->Render(game_->renderer_, rect_.x + (rect_.w / 2) - game_->mine_numbers_textures_[mines_in_vicinity_ - 1]->width_ / 2, rect_.y + 3);
+			atlas.WriteQuad(sprite_vertices, rect, atlas.GetCoveredRect(), white);
+
+			if (game_->probability_overlay_)
+			{
+				const float probability = game_->probability_engine_.GetMineProbability(index_);
+				const SDL_Color probability_color = { static_cast<Uint8>(0xFF * probability), static_cast<Uint8>(0xFF * (1.0f - probability)), 0x00, 0x80 };
+
+				atlas.WriteSolidQuad(top_vertices, rect, probability_color);
+			}
+			else
+			{
+				atlas.WriteEmptyQuad(top_vertices);
+			}
 		}
-	}	
-}
\ No newline at end of file
+	}
+	else if (board.IsMine(index_))
+	{
+		atlas.WriteQuad(sprite_vertices, rect, atlas.GetMineRect(), white);
+		atlas.WriteEmptyQuad(top_vertices);
+	}
+	else if (board.GetMinesInVicinity(index_) != 0)
+	{
+		/* Digits are rasterized for 32 pixel cells and scaled with the zoom. */
+		const SDL_Rect& digit_rect = atlas.GetDigitRect(board.GetMinesInVicinity(index_));
+		const int digit_width = digit_rect.w * rect.w / 32;
+		const int digit_height = digit_rect.h * rect.h / 32;
+		const SDL_Rect digit_destination = { rect.x + (rect.w / 2) - digit_width / 2, rect.y + 3 * rect.h / 32, digit_width, digit_height };
+
+		atlas.WriteEmptyQuad(sprite_vertices);
+		atlas.WriteQuad(top_vertices, digit_destination, digit_rect, white);
+	}
+	else
+	{
+		atlas.WriteEmptyQuad(sprite_vertices);
+		atlas.WriteEmptyQuad(top_vertices);
+	}
+}
+
+void Cell::RenderHint() const
+{
+	const SDL_Rect rect = GetRect();
+	const SDL_Rect inner_rect = { rect.x + 1, rect.y + 1, rect.w - 2, rect.h - 2 };
+
+	if (game_->hint_is_mine_)
+	{
+		SDL_SetRenderDrawColor(game_->renderer_, 0xFF, 0x00, 0x00, 0xFF);
+	}
+	else
+	{
+		SDL_SetRenderDrawColor(game_->renderer_, 0x00, 0xC0, 0x00, 0xFF);
+	}
+
+	SDL_RenderDrawRect(game_->renderer_, &rect);
+	SDL_RenderDrawRect(game_->renderer_, &inner_rect);
+	render_stats::CountDrawCall(2);
+}
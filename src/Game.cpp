@@ -1,5 +1,10 @@
 #include "Game.hpp"
+#include "BoardGenerator.hpp"
 #include "Constants.hpp"
+#include "Profiler.hpp"
+#include "Random.hpp"
+#include "RenderStats.hpp"
+#include "Snapshot.hpp"
 #include "Texture.hpp"
 
 #include <SDL2/SDL.h>
@@ -8,32 +13,59 @@
 #include <SDL2/SDL_mixer.h>
 
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
 #include <iostream>
 #include <memory>
 #include <random>
-#include <stack>
+#include <vector>
 
-Game::Game() : 
+Game::Game(bool headless, bool vsync) : 
 	initialized_(false), 
+	headless_(headless), 
+	vsync_(vsync), 
 	running_(false), 
+	redraw_(true), 
 	mouse_pressed_down_(false), 
 	game_started_(false), 
-	mines_left_(10), 
+	no_guess_(false), 
 	seconds_elapsed_(0), 
-	ticks_elapsed_(0), 
+	clock_start_time_(0), 
+	clock_stop_time_(0), 
+	seed_(0), 
 	window_(nullptr), 
 	game_over_(false), 
+	hint_visible_(false), 
+	hint_is_mine_(false), 
+	hint_index_(0), 
+	probability_overlay_(false), 
 	renderer_(nullptr), 
 	font_(nullptr),
+	hud_font_(nullptr), 
 	explosion_sfx_(nullptr), 
+	thread_pool_(std::make_unique<ThreadPool>()), 
 	small_board_button_(nullptr), 
 	medium_board_button_(nullptr), 
 	large_board_button_(nullptr), 
 	reset_board_button_(nullptr), 
-	sprites_texture_(std::make_unique<Texture>()), 
-	mines_left_texture_(std::make_unique<Texture>()), 
-	seconds_texture_(std::make_unique<Texture>())
+	board_renderer_(nullptr), 
+	probability_engine_(thread_pool_.get()), 
+	sprite_atlas_(std::make_unique<SpriteAtlas>()), 
+	text_renderer_(std::make_unique<TextRenderer>()), 
+	performance_hud_(std::make_unique<PerformanceHud>()), 
+	performance_hud_visible_(false), 
+	replay_reader_(nullptr), 
+	replaying_(false), 
+	replay_game_recorded_(false), 
+	replay_record_pending_(false), 
+	replay_record_(), 
+	replay_tick_(0), 
+	replay_due_tick_(0), 
+	autosave_path_(nullptr), 
+	autosave_time_(0)
 {
 	initialized_ = Initialize();
 
@@ -43,6 +75,9 @@ Game::Game() :
 	}
 
 	board_size_ = BoardSize::SMALL;
+	board_preset_ = GetBoardPreset(board_size_);
+
+	scheduler_.Reset(SDL_GetPerformanceFrequency(), constants::ticks_per_second);
 
 	constexpr int info_viewport_height = 100;
 
@@ -57,7 +92,8 @@ Game::Game() :
 	board_viewport_.h = board_viewport_.w;
 
 	GenerateBoard();
-	SetBoardCellFlags();
+
+	camera_.Reset(board_.GetWidth(), board_.GetHeight(), board_viewport_.w, board_viewport_.h);
 
 	constexpr int button_padding = 10;
 
@@ -73,22 +109,13 @@ Game::Game() :
 	reset_board_button_ = std::make_unique<Button>(this, font_, "Reset");
 	reset_board_button_->SetPosition((info_viewport_.w / 2) - (reset_board_button_->GetTexture()->width_ / 2), (info_viewport_.h / 1.5) - (reset_board_button_->GetTexture()->height_ / 2));
 
-	sprites_texture_->LoadFromPath(renderer_, "res/gfx/sprites.png");
+	sprite_atlas_->Load(renderer_, font_, "res/gfx/sprites.png");
 
-	UpdateMinesLeftTexture();
-	UpdateSecondsElapsedTexture();
+	board_renderer_ = std::make_unique<BoardRenderer>(this);
 
-	SDL_Color numbers_colors[8] = { { 0x00, 0x00, 0xFF, 0xFF }, { 0x00, 0xFF, 0x00, 0xFF }, { 0xFF, 0x00, 0x00, 0xFF },
-									{ 0x00, 0x61, 0x76, 0xFF }, { 0xA1, 0x61, 0x76, 0xFF }, { 0xC4, 0xBA, 0x07, 0xFF },
-									{ 0xA7, 0x14, 0x9F, 0xFF }, { 0x00, 0x00, 0x00, 0xFF } };
-
-	for (std::size_t i = 0; i < 8; ++i)
-	{
-		std::unique_ptr<Texture> texture = std::make_unique<Texture>();
-		texture->LoadFromText(renderer_, font_, std::to_string(i + 1).c_str(), numbers_colors[i], -1);
+	text_renderer_->Load(renderer_, font_);
 
-		mine_numbers_textures_.push_back(std::move(texture));
-	}
+	performance_hud_->Load(renderer_, hud_font_);
 }
 
 Game::~Game()
@@ -98,6 +125,14 @@ Game::~Game()
 
 bool Game::Initialize()
 {
+	if (headless_)
+	{
+		/* Renders into memory, no display or GPU needed. Variables that are already set win, so the dummy 
+		 * video driver can be chosen instead. */
+		SDL_setenv("SDL_VIDEODRIVER", "offscreen", 0);
+		SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+	}
+
 	if (SDL_Init(SDL_INIT_VIDEO) < 0)
 	{
 		printf("SDL could not be initialized! SDL Error: %s\n", SDL_GetError());
@@ -117,7 +152,14 @@ bool Game::Initialize()
 		return false;
 	}
 
-	renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED);
+	Uint32 renderer_flags = headless_ ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+
+	if (vsync_ && !headless_)
+	{
+		renderer_flags |= SDL_RENDERER_PRESENTVSYNC;
+	}
+
+	renderer_ = SDL_CreateRenderer(window_, -1, renderer_flags);
 
 	if (renderer_ == nullptr)
 	{
@@ -147,6 +189,14 @@ bool Game::Initialize()
 		return false;
 	}
 
+	hud_font_ = TTF_OpenFont("res/font/font.ttf", 14);
+
+	if (hud_font_ == nullptr)
+	{
+		printf("Failed to load font! SDL_ttf Error: %s\n", TTF_GetError());
+		return false;
+	}
+
 	if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
 	{
 		printf("SDL_mixer could not be initialized! SDL_mixer Error: %s\n", Mix_GetError());
@@ -160,6 +210,11 @@ bool Game::Initialize()
 
 void Game::Finalize()
 {
+	board_renderer_.reset();
+	sprite_atlas_.reset();
+	text_renderer_.reset();
+	performance_hud_.reset();
+
 	SDL_DestroyWindow(window_);
 	window_ = nullptr;
 
@@ -169,6 +224,9 @@ void Game::Finalize()
 	TTF_CloseFont(font_);
 	font_ = nullptr;
 
+	TTF_CloseFont(hud_font_);
+	hud_font_ = nullptr;
+
 	Mix_FreeChunk(explosion_sfx_);
 	explosion_sfx_ = nullptr;
 
@@ -178,7 +236,7 @@ void Game::Finalize()
 	Mix_Quit();
 }
 
-void Game::Run()
+void Game::Run(bool wait_for_events)
 {
 	if (!initialized_)
 	{
@@ -186,74 +244,258 @@ void Game::Run()
 	}
 
 	running_ = true;
+	redraw_ = true;
 
-	constexpr long double ms = 1.0 / 60.0;
-	std::uint64_t last_time = SDL_GetPerformanceCounter();
-	long double delta = 0.0;
+	/* Scheduler time carries on from where it was, in performance counter units. */
+	const std::uint64_t origin = SDL_GetPerformanceCounter() - scheduler_.GetTime();
+	constexpr std::uint64_t max_catch_up_ticks = 10;
 
-	double timer = SDL_GetTicks();
+	Uint32 timer = SDL_GetTicks();
 
 	int frames = 0;
 	int ticks = 0;
 
 	while (running_)
 	{
-		const std::uint64_t now = SDL_GetPerformanceCounter();
-		const long double elapsed = static_cast<long double>(now - last_time) / static_cast<long double>(SDL_GetPerformanceFrequency());
+		/* Ticks only matter while the clock runs, a cell is held down, the HUD counts them, a replay plays or the 
+		 * heat map waits for its update, everything else changes through events. */
+		const bool ticking = (game_started_ && !game_over_) || mouse_pressed_down_ || performance_hud_visible_ || replaying_ || 
+			probability_engine_.IsUpdating();
+
+		if (wait_for_events && !redraw_)
+		{
+			if (ticking)
+			{
+				scheduler_.SetTime(SDL_GetPerformanceCounter() - origin);
 
-		last_time = now;
-		delta += elapsed;
+				const std::uint64_t time_to_tick = scheduler_.GetTimeToNextTick();
+
+				if (time_to_tick > 0)
+				{
+					SDL_WaitEventTimeout(nullptr, static_cast<int>(std::ceil(scheduler_.ToSeconds(time_to_tick) * 1000.0)));
+				}
+			}
+			else
+			{
+				SDL_WaitEvent(nullptr);
+			}
+
+			/* After a long sleep the HUD starts a new second instead of catching up on empty ones. */
+			if (SDL_GetTicks() - timer > 2000)
+			{
+				timer = SDL_GetTicks();
+				frames = 0;
+				ticks = 0;
+			}
+		}
+
+		scheduler_.SetTime(SDL_GetPerformanceCounter() - origin);
+
+		/* Idle time is not caught up, and after a stall only the newest few ticks run. The game clock reads the 
+		 * scheduler time, not the tick count, so it stays exact either way. */
+		scheduler_.DropPendingTicks(wait_for_events && !ticking ? 0 : max_catch_up_ticks);
+
+		/* Frame time covers the work of the frame, not the time spent waiting for it. */
+		const std::uint64_t frame_start = SDL_GetPerformanceCounter();
+		render_stats::Reset();
 
 		HandleEvents();
 
-		while (delta >= ms)
+		while (scheduler_.ConsumeTick())
 		{
 			Tick();
-			delta -= ms;
 			++ticks;
 		}
 
-		//printf("%Lf\n", delta / ms);
-		Render();
-		++frames;
+		if (probability_engine_.Poll(board_))
+		{
+			board_renderer_->Invalidate();
+			redraw_ = true;
+		}
+
+		if (redraw_ || !wait_for_events)
+		{
+			Render();
+			redraw_ = false;
+			++frames;
+
+			performance_hud_->RecordFrame(scheduler_.ToSeconds(SDL_GetPerformanceCounter() - frame_start) * 1000.0, 
+				render_stats::draw_calls, render_stats::texture_uploads);
+		}
 
 		if (SDL_GetTicks() - timer > 1000)
 		{
 			timer += 1000;
-			//printf("Frames: %d, Ticks: %d\n", frames, ticks);
+			performance_hud_->RecordSecond(frames, ticks);
+			redraw_ = redraw_ || performance_hud_visible_;
 			frames = 0;
 			ticks = 0;
 		}
 	}
+
+	if (autosave_path_ != nullptr && game_started_ && !game_over_)
+	{
+		SaveGame(autosave_path_);
+	}
+}
+
+void Game::RunFrameBenchmark(int frames_per_size)
+{
+	if (!initialized_)
+	{
+		return;
+	}
+
+	constexpr int frames_per_click = 4;
+
+	for (BoardSize board_size : { BoardSize::SMALL, BoardSize::MEDIUM, BoardSize::LARGE, BoardSize::GIANT })
+	{
+		CounterRng rng(static_cast<std::uint64_t>(board_size));
+
+		ResizeWindow(board_size);
+		ResetBoard();
+		seed_ = rng();
+
+		std::vector<double> frame_milliseconds;
+		frame_milliseconds.reserve(frames_per_size);
+
+		std::size_t draw_calls = 0;
+		std::size_t texture_uploads = 0;
+
+		for (int frame = 0; frame < frames_per_size; ++frame)
+		{
+			if (frame % frames_per_click == 0)
+			{
+				std::size_t index = board_.GetIndex(board_.GetWidth() / 2, board_.GetHeight() / 2);
+				bool is_mine = false;
+
+				if (game_over_)
+				{
+					ResetBoard();
+					seed_ = rng();
+				}
+				else if (board_.AreMinesPlaced() && !solver_.GetHint(board_, &index, &is_mine))
+				{
+					do
+					{
+						index = static_cast<std::size_t>(rng.UniformBelow(board_.GetSize()));
+					}
+					while (board_.IsUncovered(index) || board_.IsFlagged(index));
+				}
+
+				if (!game_over_)
+				{
+					PushMouseClick(index, is_mine ? SDL_BUTTON_RIGHT : SDL_BUTTON_LEFT);
+				}
+			}
+
+			scheduler_.AdvanceToNextTick();
+			render_stats::Reset();
+
+			const auto start = std::chrono::steady_clock::now();
+
+			HandleEvents();
+
+			while (scheduler_.ConsumeTick())
+			{
+				Tick();
+			}
+
+			Render();
+
+			const auto end = std::chrono::steady_clock::now();
+
+			frame_milliseconds.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+			draw_calls += render_stats::draw_calls;
+			texture_uploads += render_stats::texture_uploads;
+		}
+
+		std::sort(frame_milliseconds.begin(), frame_milliseconds.end());
+
+		const auto percentile = [&frame_milliseconds](double p)
+		{
+			return frame_milliseconds.empty() ? 0.0 : frame_milliseconds[static_cast<std::size_t>(p * (frame_milliseconds.size() - 1) + 0.5)];
+		};
+
+		const BoardPreset board_preset = GetBoardPreset(board_size);
+
+		printf("%4dx%-4d %6d frames: p50 %7.3f ms p90 %7.3f ms p99 %7.3f ms max %7.3f ms, %8.1f draw calls/frame, %5.2f texture uploads/frame\n", 
+			board_preset.width_, board_preset.height_, frames_per_size, percentile(0.5), percentile(0.9), percentile(0.99), percentile(1.0), 
+			frames_per_size > 0 ? static_cast<double>(draw_calls) / frames_per_size : 0.0, 
+			frames_per_size > 0 ? static_cast<double>(texture_uploads) / frames_per_size : 0.0);
+	}
+}
+
+void Game::PushMouseClick(std::size_t index, Uint8 button)
+{
+	const int cell_x = static_cast<int>(index % board_.GetWidth());
+	const int cell_y = static_cast<int>(index / board_.GetWidth());
+
+	/* Scrolls like a player would on boards larger than the view. */
+	camera_.CenterOn(cell_x, cell_y);
+
+	const SDL_Rect rect = camera_.GetCellRect(cell_x, cell_y);
+	const int x = board_viewport_.x + rect.x + rect.w / 2;
+	const int y = board_viewport_.y + rect.y + rect.h / 2;
+
+	/* The game reads the mouse position from SDL, so the cursor has to be there when the events are handled. */
+	SDL_WarpMouseInWindow(window_, x, y);
+
+	SDL_Event e = {};
+	e.button.button = button;
+	e.button.x = x;
+	e.button.y = y;
+
+	e.type = SDL_MOUSEBUTTONDOWN;
+	SDL_PushEvent(&e);
+
+	e.type = SDL_MOUSEBUTTONUP;
+	SDL_PushEvent(&e);
 }
 
 void Game::HandleEvents()
 {
+	PROFILE_ZONE("HandleEvents");
+
 	SDL_Event e;
 
 	while (SDL_PollEvent(&e) != 0)
 	{
+		/* Any event can change what is on screen, including window exposure. */
+		redraw_ = true;
+
 		if (e.type == SDL_QUIT)
 		{
 			running_ = false;
 			return;
 		}
 
+		/* The board is kept in a render target texture, which loses its contents when targets are reset and 
+		 * is gone, with every other texture, when the device is. */
+		if (e.type == SDL_RENDER_TARGETS_RESET)
+		{
+			board_renderer_->Invalidate();
+		}
+		else if (e.type == SDL_RENDER_DEVICE_RESET)
+		{
+			ReloadTextures();
+		}
+
 		if (e.type == SDL_MOUSEBUTTONUP)
 		{
-			if (small_board_button_->MouseOverlapsButton())
+			if (small_board_button_->ContainsPoint(e.button.x, e.button.y))
 			{
 				ResizeWindow(BoardSize::SMALL);
 			}
-			else if (medium_board_button_->MouseOverlapsButton())
+			else if (medium_board_button_->ContainsPoint(e.button.x, e.button.y))
 			{
 				ResizeWindow(BoardSize::MEDIUM);
 			}
-			else if (large_board_button_->MouseOverlapsButton())
+			else if (large_board_button_->ContainsPoint(e.button.x, e.button.y))
 			{
 				ResizeWindow(BoardSize::LARGE);
 			}
-			else if (reset_board_button_->MouseOverlapsButton())
+			else if (reset_board_button_->ContainsPoint(e.button.x, e.button.y))
 			{
 				ResetBoard();
 			}
@@ -264,9 +506,88 @@ void Game::HandleEvents()
 			medium_board_button_->HandleEvent(&e);
 			large_board_button_->HandleEvent(&e);
 			reset_board_button_->HandleEvent(&e);
+
+			if (e.motion.state & SDL_BUTTON_MMASK)
+			{
+				camera_.Pan(-e.motion.xrel, -e.motion.yrel);
+			}
 		}
+		else if (e.type == SDL_MOUSEWHEEL)
+		{
+			SDL_Point mouse_position = { 0, 0 };
+			SDL_GetMouseState(&mouse_position.x, &mouse_position.y);
 
-		if (game_over_)
+			camera_.Zoom(e.wheel.y, mouse_position.x - board_viewport_.x, mouse_position.y - board_viewport_.y);
+		}
+		else if (e.type == SDL_KEYDOWN)
+		{
+			const int pan_step = camera_.GetCellSize() * 4;
+
+			if (e.key.keysym.sym == SDLK_n)
+			{
+				no_guess_ = !no_guess_;
+				ResetBoard();
+			}
+			else if (e.key.keysym.sym == SDLK_h)
+			{
+				ShowHint();
+			}
+			else if (e.key.keysym.sym == SDLK_p)
+			{
+				probability_overlay_ = !probability_overlay_;
+				board_renderer_->Invalidate();
+				UpdateProbabilities();
+			}
+#ifdef MINESWEEPER_PROFILE
+			else if (e.key.keysym.sym == SDLK_t)
+			{
+				profiler::WriteTrace("trace.json");
+			}
+#endif
+			else if (e.key.keysym.sym == SDLK_F3)
+			{
+				performance_hud_visible_ = !performance_hud_visible_;
+			}
+			else if (e.key.keysym.sym == SDLK_F5)
+			{
+				SaveGame(constants::save_path);
+			}
+			else if (e.key.keysym.sym == SDLK_F9)
+			{
+				LoadGame(constants::save_path);
+			}
+			else if (e.key.keysym.sym == SDLK_g)
+			{
+				ResizeWindow(BoardSize::GIANT);
+			}
+			else if (e.key.keysym.sym == SDLK_LEFT)
+			{
+				camera_.Pan(-pan_step, 0);
+			}
+			else if (e.key.keysym.sym == SDLK_RIGHT)
+			{
+				camera_.Pan(pan_step, 0);
+			}
+			else if (e.key.keysym.sym == SDLK_UP)
+			{
+				camera_.Pan(0, -pan_step);
+			}
+			else if (e.key.keysym.sym == SDLK_DOWN)
+			{
+				camera_.Pan(0, pan_step);
+			}
+			else if (e.key.keysym.sym == SDLK_EQUALS)
+			{
+				camera_.Zoom(1, board_viewport_.w / 2, board_viewport_.h / 2);
+			}
+			else if (e.key.keysym.sym == SDLK_MINUS)
+			{
+				camera_.Zoom(-1, board_viewport_.w / 2, board_viewport_.h / 2);
+			}
+		}
+
+		/* The board only takes input from the replay while one plays. */
+		if (game_over_ || replaying_)
 		{
 			continue;
 		}
@@ -288,57 +609,247 @@ void Game::HandleEvents()
 				}
 				else if (e.type == SDL_MOUSEBUTTONUP)
 				{
-					if (!game_started_)
-					{
-						game_started_ = true;
-					}
-
 					mouse_pressed_down_ = false;
-					
-					if (!board_[mouse_index].uncovered_)
-					{
-						UncoverCells(mouse_index);
-					}
-					else
-					{
-						UncoverAvailableNeighbourCells(mouse_index);
-						ResetRenderCellFlags(mouse_index);
-					}
+					ClickCell(mouse_index);
 				}
 			}
 			else if (e.button.button == SDL_BUTTON_RIGHT)
 			{
 				if (e.type == SDL_MOUSEBUTTONDOWN)
 				{
-					if (!board_[mouse_index].uncovered_)
-					{
-						board_[mouse_index].render_cell_ = true;
-						
-						if (board_[mouse_index].flag_)
-						{
-							++mines_left_;
-							board_[mouse_index].flag_ = false;
-						}
-						else
-						{
-							--mines_left_;
-							board_[mouse_index].flag_ = true;
-						}
-						
-						UpdateMinesLeftTexture();
-					}
+					FlagCell(mouse_index);
 				}
 			}
 		}
 	}
 }
+
+void Game::ClickCell(std::size_t index)
+{
+	RecordReplayEvent(board_.IsUncovered(index) ? ReplayAction::CHORD : ReplayAction::REVEAL, index);
+
+	if (!game_started_)
+	{
+		game_started_ = true;
+		clock_start_time_ = scheduler_.GetTime();
+	}
+
+	if (!board_.AreMinesPlaced())
+	{
+		PROFILE_ZONE("GenerateBoard");
+
+		if (no_guess_)
+		{
+			GenerateNoGuessBoard(board_, seed_, index, *thread_pool_);
+		}
+		else
+		{
+			board_.PlaceMines(seed_, index);
+		}
+	}
+
+	hint_visible_ = false;
+	
+	if (!board_.IsUncovered(index))
+	{
+		UncoverCells(index);
+	}
+	else
+	{
+		UncoverAvailableNeighbourCells(index);
+		ResetRenderCellFlags(index);
+	}
+
+	UpdateProbabilities();
+}
+
+void Game::FlagCell(std::size_t index)
+{
+	if (!board_.ToggleFlag(index))
+	{
+		return;
+	}
+
+	RecordReplayEvent(ReplayAction::FLAG, index);
+
+	hint_visible_ = false;
+	board_.SetPressed(index, false);
+	UpdateProbabilities();
+}
+
+void Game::EnableAutosave(const char* path)
+{
+	autosave_path_ = path;
+	autosave_time_ = scheduler_.GetTime();
+}
+
+bool Game::SaveGame(const char* path)
+{
+	const SnapshotInfo info = { static_cast<std::uint64_t>(std::llround(scheduler_.ToSeconds(GetElapsedTime()) * 1e6)), game_started_, no_guess_ };
+
+	return SaveSnapshot(path, board_, info);
+}
+
+bool Game::LoadGame(const char* path)
+{
+	SnapshotInfo info = {};
+
+	if (!LoadSnapshot(path, board_, &info))
+	{
+		return false;
+	}
+
+	SetBoardPreset({ board_.GetWidth(), board_.GetHeight(), board_.GetMines() });
+
+	/* The moves that led here are not in the replay log, so the rest of this game is not recorded either. */
+	replay_writer_.Flush();
+	replay_game_recorded_ = true;
+	replaying_ = false;
+
+	game_over_ = board_.GetState() != BoardState::PLAYING;
+	game_started_ = info.game_started_;
+	no_guess_ = info.no_guess_;
+	mouse_pressed_down_ = false;
+	hint_visible_ = false;
+
+	if (board_.AreMinesPlaced())
+	{
+		seed_ = board_.GetSeed();
+	}
+
+	/* Unsigned arithmetic wraps, so the difference comes out right even before the scheduler has run that long. */
+	const std::uint64_t elapsed_time = scheduler_.FromSeconds(info.elapsed_microseconds_ / 1e6);
+
+	clock_stop_time_ = scheduler_.GetTime();
+	clock_start_time_ = clock_stop_time_ - elapsed_time;
+	seconds_elapsed_ = static_cast<int>(GetElapsedTime() / scheduler_.GetFrequency());
+
+	board_renderer_->Invalidate();
+	UpdateProbabilities();
+	redraw_ = true;
+
+	return true;
+}
+
+bool Game::StartRecording(const char* path)
+{
+	return replay_writer_.Open(path);
+}
+
+void Game::RecordReplayEvent(ReplayAction action, std::size_t index)
+{
+	if (!replay_writer_.IsOpen() || replaying_)
+	{
+		return;
+	}
+
+	/* Games nobody clicked on are not recorded. */
+	if (!replay_game_recorded_)
+	{
+		replay_writer_.BeginGame({ seed_, board_.GetWidth(), board_.GetHeight(), board_.GetMines(), no_guess_ });
+		replay_game_recorded_ = true;
+		replay_tick_ = scheduler_.GetTicks();
+	}
+
+	replay_writer_.WriteEvent(action, scheduler_.GetTicks() - replay_tick_, index);
+	replay_tick_ = scheduler_.GetTicks();
+}
+
+bool Game::LoadReplay(const char* path)
+{
+	replay_reader_ = std::make_unique<ReplayReader>();
+	replaying_ = replay_reader_->Open(path);
+	replay_record_pending_ = false;
+	replay_tick_ = scheduler_.GetTicks();
+
+	return replaying_;
+}
+
+void Game::PlayReplay()
+{
+	/* Pause between the end of one game and the start of the next. */
+	constexpr std::uint64_t game_over_pause_ticks = 2 * constants::ticks_per_second;
+
+	while (replaying_)
+	{
+		if (!replay_record_pending_)
+		{
+			if (!replay_reader_->Next(&replay_record_))
+			{
+				printf("Replay finished\n");
+				replaying_ = false;
+				break;
+			}
+
+			replay_record_pending_ = true;
+
+			if (replay_record_.action_ == ReplayAction::NEW_GAME)
+			{
+				replay_due_tick_ = replay_tick_ + (game_started_ ? game_over_pause_ticks : 0);
+			}
+			else
+			{
+				replay_due_tick_ = replay_tick_ + replay_record_.ticks_;
+			}
+		}
+
+		if (scheduler_.GetTicks() < replay_due_tick_)
+		{
+			break;
+		}
+
+		replay_record_pending_ = false;
+		replay_tick_ = replay_due_tick_;
+
+		if (replay_record_.action_ == ReplayAction::NEW_GAME)
+		{
+			const ReplayGame& game = replay_record_.game_;
+
+			SetBoardPreset({ game.width_, game.height_, game.mines_ });
+			ResetBoard();
+			seed_ = game.seed_;
+			no_guess_ = game.no_guess_;
+		}
+		else if (replay_record_.cell_ >= board_.GetSize())
+		{
+			printf("Replay record outside the board\n");
+			replaying_ = false;
+		}
+		else if (replay_record_.action_ == ReplayAction::FLAG)
+		{
+			FlagCell(replay_record_.cell_);
+		}
+		else
+		{
+			ClickCell(replay_record_.cell_);
+		}
+
+		redraw_ = true;
+	}
+}
 	
+void Game::ReloadTextures()
+{
+	sprite_atlas_->Load(renderer_, font_, "res/gfx/sprites.png");
+	text_renderer_->Load(renderer_, font_);
+	performance_hud_->Load(renderer_, hud_font_);
+
+	small_board_button_->LoadTextures();
+	medium_board_button_->LoadTextures();
+	large_board_button_->LoadTextures();
+	reset_board_button_->LoadTextures();
+
+	board_renderer_->ReleaseTarget();
+}
+
 void Game::Tick()
 {
-	small_board_button_->Tick();
-	medium_board_button_->Tick();
-	large_board_button_->Tick();
-	reset_board_button_->Tick();
+	PROFILE_ZONE("Tick");
+
+	if (replaying_)
+	{
+		PlayReplay();
+	}
 
 	if (game_over_)
 	{
@@ -347,15 +858,19 @@ void Game::Tick()
 
 	if (game_started_)
 	{
-		++ticks_elapsed_;
+		const int seconds_elapsed = static_cast<int>(GetElapsedTime() / scheduler_.GetFrequency());
 
-		/* This is bad. */
-		if (ticks_elapsed_ % 60 == 0)
+		if (seconds_elapsed != seconds_elapsed_)
 		{
-			++seconds_elapsed_;
+			seconds_elapsed_ = seconds_elapsed;
+			redraw_ = true;
 		}
 
-		UpdateSecondsElapsedTexture();
+		if (autosave_path_ != nullptr && scheduler_.GetTime() - autosave_time_ >= scheduler_.FromSeconds(constants::autosave_interval_seconds))
+		{
+			SaveGame(autosave_path_);
+			autosave_time_ = scheduler_.GetTime();
+		}
 	}
 
 	std::size_t mouse_index = 0;
@@ -367,24 +882,25 @@ void Game::Tick()
 
 	if (mouse_pressed_down_)
 	{
+		redraw_ = true;
 		ResetRenderCellFlags(mouse_index);
 		
-		if (!board_[mouse_index].uncovered_)
+		if (!board_.IsUncovered(mouse_index))
 		{
-			if (board_[mouse_index].render_cell_ && !board_[mouse_index].flag_)
+			if (!board_.IsFlagged(mouse_index))
 			{
-				board_[mouse_index].render_cell_ = false;
+				board_.SetPressed(mouse_index, true);
 			}
 		}
 		else
 		{
-			std::vector<std::size_t> neighbour_indices = GetNeighboursIndices(mouse_index);
+			const NeighbourIndices neighbour_indices = board_.GetNeighboursIndices(mouse_index);
 
 			for (std::size_t neighbour_index : neighbour_indices)
 			{
-				if (board_[neighbour_index].render_cell_ && !board_[neighbour_index].flag_)
+				if (!board_.IsFlagged(neighbour_index))
 				{
-					board_[neighbour_index].render_cell_ = false;
+					board_.SetPressed(neighbour_index, true);
 				}
 			}
 		}
@@ -393,77 +909,76 @@ void Game::Tick()
 
 void Game::Render()
 {
+	PROFILE_ZONE("Render");
+
 	SDL_SetRenderDrawColor(renderer_, 0xC6, 0xC6, 0xC6, 0xFF);
 	SDL_RenderClear(renderer_);
+	render_stats::CountDrawCall();
 
 	RenderInfo();
 	RenderBoard();
 
-	std::for_each(board_.begin(), board_.end(), [](const Cell& cell)
-	{
-		cell.Render();
-	});
-
 	SDL_RenderPresent(renderer_);
 }
 
 void Game::RenderInfo()
 {
+	PROFILE_ZONE("RenderInfo");
+
 	SDL_RenderSetViewport(renderer_, &info_viewport_);	
 	SDL_SetRenderDrawColor(renderer_, 0x80, 0x80, 0x80, 0xFF);
 	SDL_RenderDrawLine(renderer_, 0, info_viewport_.h - 1, board_viewport_.w, info_viewport_.h - 1);
+	render_stats::CountDrawCall();
 
 	small_board_button_->Render();
 	medium_board_button_->Render();
 	large_board_button_->Render();
 	reset_board_button_->Render();
 
-	mines_left_texture_->Render(renderer_, (info_viewport_.w / 3) - ((info_viewport_.w / 3) / 2) - (mines_left_texture_->width_ / 2), (info_viewport_.h / 1.5) - (mines_left_texture_->height_ / 2));
-	seconds_texture_->Render(renderer_, (info_viewport_.w * 2 / 3) + (info_viewport_.w / 3 / 2) - (seconds_texture_->width_ / 2), (info_viewport_.h / 1.5) - (seconds_texture_->height_ / 2));
+	/* Counters are formatted every frame, the glyph atlas makes that cheaper than caching textures. */
+	const SDL_Color text_color = { 0x00, 0x00, 0x00, 0xFF };
+	char text[16];
+	int text_width = 0;
+	int text_height = 0;
+
+	snprintf(text, sizeof(text), "%d", board_.GetMinesLeft());
+	text_renderer_->MeasureText(text, &text_width, &text_height);
+	text_renderer_->DrawText(text, (info_viewport_.w / 3) - ((info_viewport_.w / 3) / 2) - (text_width / 2), (info_viewport_.h / 1.5) - (text_height / 2), text_color);
+
+	snprintf(text, sizeof(text), "%d", seconds_elapsed_);
+	text_renderer_->MeasureText(text, &text_width, &text_height);
+	text_renderer_->DrawText(text, (info_viewport_.w * 2 / 3) + (info_viewport_.w / 3 / 2) - (text_width / 2), (info_viewport_.h / 1.5) - (text_height / 2), text_color);
+
+	text_renderer_->Flush(renderer_);
+
+	if (performance_hud_visible_)
+	{
+		const SDL_Rect hud_area = { 0, 0, info_viewport_.w, info_viewport_.h - 1 };
+		performance_hud_->Render(renderer_, hud_area, board_.GetMemoryUsage());
+	}
 }
 	
 void Game::RenderBoard()
 {
-	SDL_RenderSetViewport(renderer_, &board_viewport_);
-	SDL_SetRenderDrawColor(renderer_, 0x80, 0x80, 0x80, 0xFF);
-
-	int increment = 32;
+	PROFILE_ZONE("RenderBoard");
 
-	for (int i = 0; i < board_viewport_.w / 32; ++i)
-	{
-		SDL_RenderDrawLine(renderer_, increment, 0, increment, board_viewport_.h);
-		SDL_RenderDrawLine(renderer_, 0, increment, board_viewport_.w, increment);
-
-		increment += 32;
-	}
+	SDL_RenderSetViewport(renderer_, &board_viewport_);
+	board_renderer_->Render();
 }
 
 void Game::DebugBoard()
 {
-	int width_in_cells = 0;
-
-	switch (board_size_)
-	{
-	case BoardSize::SMALL:
-		width_in_cells = 10;
-		break;
-	case BoardSize::MEDIUM:
-		width_in_cells = 16;
-		break;
-	case BoardSize::LARGE:
-		width_in_cells = 32;
-		break;
-	}
+	const std::size_t width_in_cells = board_.GetWidth();
 
-	for (std::size_t i = 0; i < board_.size(); ++i)
+	for (std::size_t i = 0; i < board_.GetSize(); ++i)
 	{
-		if (board_[i].mine_)
+		if (board_.IsMine(i))
 		{
 			std::cout << "X ";
 		}
 		else
 		{
-			std::cout << std::to_string(board_[i].mines_in_vicinity_) << " ";
+			std::cout << std::to_string(board_.GetMinesInVicinity(i)) << " ";
 		}
 
 		if ((i + 1) % width_in_cells == 0)
@@ -480,34 +995,40 @@ void Game::ResizeWindow(BoardSize new_board_size)
 		return;
 	}
 
-	int new_info_viewport_width = 0;
-	constexpr int info_viewport_height = 100;
+	SetBoardPreset(GetBoardPreset(new_board_size));
+
+	ResetBoard();
+}
 
-	int new_board_viewport_width = 0;
-	int new_board_viewport_height = 0;
-
-	switch (new_board_size)
-	{
-	case BoardSize::SMALL:
-		new_info_viewport_width = 320;
-		new_board_viewport_width = 320;
-		new_board_viewport_height = 320;
-		mines_left_ = 10;
-		break;
-	case BoardSize::MEDIUM:
-		new_info_viewport_width = 512;
-		new_board_viewport_width = 512;
-		new_board_viewport_height = 512;
-		mines_left_ = 40;
-		break;
-	case BoardSize::LARGE:
-		new_info_viewport_width = 1024;
-		new_board_viewport_width = 1024;
-		new_board_viewport_height = 512;
-		mines_left_ = 99;
-		break;
+void Game::SetBoardPreset(const BoardPreset& board_preset)
+{
+	if (board_preset.width_ == board_preset_.width_ && board_preset.height_ == board_preset_.height_ && board_preset.mines_ == board_preset_.mines_)
+	{
+		return;
 	}
 
+	if (!FindBoardPreset(board_preset.width_, board_preset.height_, board_preset.mines_, &board_size_))
+	{
+		board_size_ = BoardSize::CUSTOM;
+	}
+
+	board_preset_ = board_preset;
+
+	LayoutWindow();
+
+	camera_.Reset(board_preset_.width_, board_preset_.height_, board_viewport_.w, board_viewport_.h);
+}
+
+void Game::LayoutWindow()
+{
+	constexpr int sprite_size = 32;
+	constexpr int info_viewport_height = 100;
+
+	/* Boards that do not fit are scrolled and zoomed through the camera. */
+	const int new_board_viewport_width = std::min(board_preset_.width_, constants::max_board_viewport_width / sprite_size) * sprite_size;
+	const int new_board_viewport_height = std::min(board_preset_.height_, constants::max_board_viewport_height / sprite_size) * sprite_size;
+	const int new_info_viewport_width = new_board_viewport_width;
+
 	info_viewport_.w = new_info_viewport_width;
 	info_viewport_.h = info_viewport_height;
 
@@ -517,10 +1038,6 @@ void Game::ResizeWindow(BoardSize new_board_size)
 	SDL_SetWindowSize(window_, new_board_viewport_width, info_viewport_height + new_board_viewport_height);
 	SDL_SetWindowPosition(window_, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED);
 
-	board_size_ = new_board_size;
-
-	ResetBoard();
-
 	constexpr int button_padding = 10;
 
 	small_board_button_->SetPosition(button_padding, 0);
@@ -531,82 +1048,36 @@ void Game::ResizeWindow(BoardSize new_board_size)
 
 void Game::ResetRenderCellFlags(std::size_t current_mouse_index)
 {
-	for (std::size_t i = 0; i < board_.size(); ++i)
-	{
-		if (i != current_mouse_index && !board_[i].uncovered_)
-		{
-			board_[i].render_cell_ = true;
-		}
-	}
-}
+	PROFILE_ZONE("ResetRenderCellFlags");
 
-void Game::UpdateMinesLeftTexture()
-{
-	SDL_Color text_color = { 0x00, 0x00, 0x00, 0xFF };
-	mines_left_texture_->LoadFromText(renderer_, font_, std::to_string(mines_left_).c_str(), text_color, -1);
-}
+	const bool current_pressed = board_.IsPressed(current_mouse_index);
 
-void Game::UpdateSecondsElapsedTexture()
-{
-	const SDL_Color text_color = { 0x00, 0x00, 0x00, 0xFF };
-	seconds_texture_->LoadFromText(renderer_, font_, std::to_string(seconds_elapsed_).c_str(), text_color, -1);
+	board_.ClearPressed();
+	board_.SetPressed(current_mouse_index, current_pressed);
 }
 
 void Game::ResetBoard()
 {
+	replay_writer_.Flush();
+	replay_game_recorded_ = false;
+
 	game_over_ = false;
 	game_started_ = false;
+	hint_visible_ = false;
 	seconds_elapsed_ = 0;
-	UpdateSecondsElapsedTexture();
-
-	switch (board_size_)
-	{
-	case BoardSize::SMALL:
-		mines_left_ = 10;
-		break;
-	case BoardSize::MEDIUM:
-		mines_left_ = 40;
-		break;
-	case BoardSize::LARGE:
-		mines_left_ = 99;
-		break;
-	}
-
-	UpdateMinesLeftTexture();
 
 	GenerateBoard();
-	SetBoardCellFlags();
+
+	UpdateProbabilities();
 }
 
 void Game::GenerateBoard()
 {
-	constexpr int sprite_size = 32;
-
-	board_.clear();
+	board_.Reset(board_preset_.width_, board_preset_.height_, board_preset_.mines_);
 
-	for (int i = 0; i < (board_viewport_.w / sprite_size) * (board_viewport_.h / sprite_size); ++i)
-	{
-		board_.emplace_back(this);
-	}
-
-	int rect_x = 0;
-	int rect_y = 0;
-
-	for (std::size_t i = 0; i < board_.size(); ++i)
-	{
-		if (i != 0 && (i * sprite_size) % board_viewport_.w == 0)
-		{
-			rect_y += sprite_size;
-			rect_x = 0;
-		}
-
-		board_[i].rect_.x = rect_x;
-		board_[i].rect_.y = rect_y;
-		board_[i].rect_.w = sprite_size;
-		board_[i].rect_.h = board_[i].rect_.w;
-
-		rect_x += sprite_size; 
-	}
+	/* Mines are placed on the first click, so only the seed is chosen here. */
+	std::random_device random_device;
+	seed_ = (static_cast<std::uint64_t>(random_device()) << 32) | random_device();
 }
 
 bool Game::GetMousePositionIndex(std::size_t* index)
@@ -614,214 +1085,78 @@ bool Game::GetMousePositionIndex(std::size_t* index)
 	SDL_Point mouse_position = { 0, 0 };
 	SDL_GetMouseState(&mouse_position.x, &mouse_position.y);
 
-	if (mouse_position.x < 0 || mouse_position.x > board_viewport_.w || 
-		mouse_position.y - info_viewport_.h < 0 || mouse_position.y - info_viewport_.h > board_viewport_.h)
+	if (mouse_position.x < 0 || mouse_position.x >= board_viewport_.w || 
+		mouse_position.y - info_viewport_.h < 0 || mouse_position.y - info_viewport_.h >= board_viewport_.h)
 	{
 		return false;
 	}
 
-	constexpr std::size_t sprite_size = 32;
-	const std::size_t x = mouse_position.x / sprite_size;
-	const std::size_t y = (mouse_position.y - info_viewport_.h) / sprite_size;
-	const std::size_t mouse_index = (y * (board_viewport_.w / sprite_size)) + x;
+	int x = 0;
+	int y = 0;
 
-	*index = mouse_index;
+	if (!camera_.GetCellAt(mouse_position.x - board_viewport_.x, mouse_position.y - board_viewport_.y, &x, &y) || !board_.Contains(x, y))
+	{
+		return false;
+	}
+
+	*index = board_.GetIndex(x, y);
 	return true;
 }
 
-
-void Game::SetBoardCellFlags()
+std::uint64_t Game::GetElapsedTime() const
 {
-	std::mt19937_64 mt{ std::random_device{}() };
-	std::uniform_int_distribution<int> random_index{ 0, static_cast<int>(board_.size() - 1) };
-
-	for (int i = 0; i < mines_left_; ++i)
+	if (!game_started_)
 	{
-		int mine_index = random_index(mt);
-
-		while (board_[mine_index].mine_)
-		{
-			mine_index = random_index(mt);
-		}
-
-		board_[mine_index].mine_ = true;
+		return 0;
 	}
 
-	for (std::size_t i = 0; i < board_.size(); ++i)
-	{
-		for (std::size_t neighbour_index : GetNeighboursIndices(i))
-		{
-			if (board_[neighbour_index].mine_)
-			{
-				++board_[i].mines_in_vicinity_;
-			}
-		}
-	}
-	
-	//DebugBoard();
+	return (game_over_ ? clock_stop_time_ : scheduler_.GetTime()) - clock_start_time_;
 }
 
 void Game::UncoverCells(std::size_t start_index)
 {
-	if (board_[start_index].mine_)
-	{
-		game_over_ = true;
-		Mix_PlayChannel(-1, explosion_sfx_, 0);
-		board_[start_index].mine_exploded_ = true;
-
-		for (std::size_t i = 0; i < board_.size(); ++i)
-		{
-			if (board_[i].mine_ && !board_[i].flag_)
-			{
-				board_[i].Uncover();
-			}
-		}
-
-		return;
-	}
-
-	board_[start_index].Uncover();
-
-	int free_cells_remaining = std::count_if(board_.begin(), board_.end(), [](const Cell& cell)
-	{
-		return !cell.mine_ && !cell.uncovered_;
-	});
-
-	if (free_cells_remaining == 0)
-	{
-		game_over_ = true;
-		mines_left_ = 0;
-		UpdateMinesLeftTexture();
-
-		for (std::size_t i = 0; i < board_.size(); ++i)
-		{
-			if (board_[i].mine_)
-			{
-				board_[i].flag_ = true;
-			}
-		}
-
-		return;
-	}
-
-	if (board_[start_index].mines_in_vicinity_ != 0)
-	{
-		return;
-	}
-
-	std::stack<std::size_t> indices_stack;
-	std::vector<std::size_t> neighbour_indices = GetNeighboursIndices(start_index);
+	PROFILE_ZONE("UncoverCells");
 
-	for (std::size_t neighbour_index : neighbour_indices)
-	{
-		if (!board_[neighbour_index].uncovered_)
-		{
-			indices_stack.push(neighbour_index);
-		}
-	}
-
-	while (!indices_stack.empty())
-	{
-		std::size_t top_index = indices_stack.top();
-		indices_stack.pop();
-
-		if (board_[top_index].uncovered_)
-		{
-			continue;
-		}
-
-		board_[top_index].Uncover();
-
-		if (board_[top_index].mines_in_vicinity_ != 0)
-		{
-			continue;
-		}
-
-		neighbour_indices = GetNeighboursIndices(top_index);
-
-		for (std::size_t neighbour_index : neighbour_indices)
-		{
-			if (!board_[neighbour_index].uncovered_)
-			{			
-				indices_stack.push(neighbour_index);
-			}
-		}
-	}
+	HandleBoardState(board_.Reveal(start_index));
 }
 
 void Game::UncoverAvailableNeighbourCells(std::size_t start_index)
 {
-	std::vector<std::size_t> neighbour_indices = GetNeighboursIndices(start_index);
+	PROFILE_ZONE("UncoverAvailableNeighbourCells");
 
-	int flagged_mines = std::count_if(neighbour_indices.begin(), neighbour_indices.end(), [this](std::size_t neighbour_index)
-		{
-			return board_[neighbour_index].flag_;
-		});
-
-	if (flagged_mines == board_[start_index].mines_in_vicinity_)
-	{
-		for (std::size_t neighbour_index : neighbour_indices)
-		{
-			if (!board_[neighbour_index].flag_)
-			{
-				UncoverCells(neighbour_index);
-			}
-		}
-	}
+	HandleBoardState(board_.Chord(start_index));
 }
 
-
-std::vector<std::size_t> Game::GetNeighboursIndices(std::size_t cell_index)
+void Game::UpdateProbabilities()
 {
-	std::vector<std::size_t> result_indices;
-	
-	constexpr int sprite_size = 32;
-	const SDL_Rect cell_rect = board_[cell_index].rect_;
-
-	bool left_cell_available = cell_rect.x - sprite_size >= 0;
-	bool right_cell_available = cell_rect.x + sprite_size < board_viewport_.w;
-	bool upper_cell_available = cell_rect.y - sprite_size >= 0;
-	bool lower_cell_available = cell_rect.y + sprite_size < board_viewport_.h;
-
-	if (left_cell_available)
-	{
-		result_indices.emplace_back(cell_index - 1);
-	}
+	PROFILE_ZONE("UpdateProbabilities");
 
-	if (right_cell_available)
+	/* The heat map keeps showing the previous probabilities until Run polls the new ones. */
+	if (probability_overlay_)
 	{
-		result_indices.emplace_back(cell_index + 1);
-	}
-
-	if (upper_cell_available)
-	{
-		result_indices.emplace_back(cell_index - (board_viewport_.w / sprite_size));
-	}
-
-	if (lower_cell_available)
-	{
-		result_indices.emplace_back(cell_index + (board_viewport_.w / sprite_size));
+		probability_engine_.RequestUpdate();
 	}
+}
 
-	if (left_cell_available && upper_cell_available)
-	{
-		result_indices.emplace_back(cell_index - (board_viewport_.w / sprite_size) - 1);
-	}
+void Game::ShowHint()
+{
+	hint_visible_ = solver_.GetHint(board_, &hint_index_, &hint_is_mine_);
+}
 
-	if (left_cell_available && lower_cell_available)
+void Game::HandleBoardState(BoardState board_state)
+{
+	if (game_over_ || board_state == BoardState::PLAYING)
 	{
-		result_indices.emplace_back(cell_index + (board_viewport_.w / sprite_size) - 1);
+		return;
 	}
 
-	if (right_cell_available && upper_cell_available)
-	{
-		result_indices.emplace_back(cell_index - (board_viewport_.w / sprite_size) + 1);
-	}
+	game_over_ = true;
+	replay_writer_.Flush();
+	clock_stop_time_ = scheduler_.GetTime();
+	seconds_elapsed_ = static_cast<int>(GetElapsedTime() / scheduler_.GetFrequency());
 
-	if (right_cell_available && lower_cell_available)
+	if (board_state == BoardState::LOST)
 	{
-		result_indices.emplace_back(cell_index + (board_viewport_.w / sprite_size) + 1);
+		Mix_PlayChannel(-1, explosion_sfx_, 0);
 	}
-
-	return result_indices;
-}
\ No newline at end of file
+}
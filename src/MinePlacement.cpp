@@ -0,0 +1,65 @@
+#include "MinePlacement.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	/* Maps a rank among the cells that are not excluded to its board index. excluded_indices must be sorted and unique. */
+	std::size_t GetIndexFromRank(std::size_t rank, const std::vector<std::size_t>& excluded_indices)
+	{
+		for (std::size_t excluded_index : excluded_indices)
+		{
+			if (excluded_index > rank)
+			{
+				break;
+			}
+
+			++rank;
+		}
+
+		return rank;
+	}
+} // namespace
+
+std::size_t SampleMines(BitPlane& mine_plane, std::size_t mines, std::vector<std::size_t> excluded_indices, CounterRng& rng)
+{
+	const std::size_t size = mine_plane.GetSize();
+
+	std::sort(excluded_indices.begin(), excluded_indices.end());
+	excluded_indices.erase(std::unique(excluded_indices.begin(), excluded_indices.end()), excluded_indices.end());
+	excluded_indices.erase(std::lower_bound(excluded_indices.begin(), excluded_indices.end(), size), excluded_indices.end());
+
+	const std::size_t available = size - excluded_indices.size();
+	mines = std::min(mines, available);
+
+	/* Above half density it is cheaper to fill every free cell and sample the cells that stay safe. */
+	const bool sample_safe_cells = mines > available / 2;
+	const std::size_t picks = sample_safe_cells ? available - mines : mines;
+
+	if (sample_safe_cells)
+	{
+		mine_plane.Fill();
+
+		for (std::size_t excluded_index : excluded_indices)
+		{
+			mine_plane.Unset(excluded_index);
+		}
+	}
+
+	for (std::size_t j = available - picks; j < available; ++j)
+	{
+		std::size_t index = GetIndexFromRank(rng.UniformBelow(j + 1), excluded_indices);
+
+		if (mine_plane.Get(index) != sample_safe_cells)
+		{
+			index = GetIndexFromRank(j, excluded_indices);
+		}
+
+		mine_plane.Assign(index, !sample_safe_cells);
+	}
+
+	return mines;
+}
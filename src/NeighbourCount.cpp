@@ -0,0 +1,291 @@
+#include "NeighbourCount.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NEIGHBOUR_COUNT_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(NEIGHBOUR_COUNT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NEIGHBOUR_COUNT_AVX2 1
+#define NEIGHBOUR_COUNT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+	/* Row buffers are padded so vector loops can run past the board width without bounds checks. */
+	constexpr std::size_t row_padding = 64;
+
+	struct RowKernels
+	{
+		void (*horizontal_sum_)(const std::uint8_t* padded_mines, std::uint8_t* sums, std::size_t count);
+		void (*vertical_sum_)(const std::uint8_t* upper, const std::uint8_t* middle, const std::uint8_t* lower, const std::uint8_t* mines, std::uint8_t* counts, std::size_t count);
+		void (*pack_nibbles_)(const std::uint8_t* counts, std::uint8_t* packed, std::size_t pairs);
+	};
+
+	/* Byte b expanded to eight bytes holding its bits, least significant bit first. */
+	const std::array<std::uint64_t, 256> bit_expansion_table = []
+	{
+		std::array<std::uint64_t, 256> table{};
+
+		for (std::size_t byte = 0; byte < table.size(); ++byte)
+		{
+			for (std::size_t bit = 0; bit < 8; ++bit)
+			{
+				table[byte] |= static_cast<std::uint64_t>((byte >> bit) & 1) << (bit * 8);
+			}
+		}
+
+		return table;
+	}();
+
+	std::uint8_t ReadByteAt(const BitPlane& plane, std::size_t bit_index)
+	{
+		const std::uint64_t* words = plane.GetWords();
+		const std::size_t word_index = bit_index >> 6;
+		const std::size_t shift = bit_index & 63;
+
+		std::uint64_t bits = words[word_index] >> shift;
+
+		if (shift > 56 && word_index + 1 < plane.GetWordCount())
+		{
+			bits |= words[word_index + 1] << (64 - shift);
+		}
+
+		return static_cast<std::uint8_t>(bits);
+	}
+
+	/* Unpacks `width` bits starting at row_start into bytes, leaving zeros after them. */
+	void ExpandRow(const BitPlane& mine_plane, std::size_t row_start, std::size_t width, std::uint8_t* mines)
+	{
+		for (std::size_t x = 0; x < width; x += 8)
+		{
+			std::memcpy(mines + x, &bit_expansion_table[ReadByteAt(mine_plane, row_start + x)], 8);
+		}
+
+		std::memset(mines + width, 0, row_padding);
+	}
+
+	void HorizontalSumScalar(const std::uint8_t* padded_mines, std::uint8_t* sums, std::size_t count)
+	{
+		for (std::size_t x = 0; x < count; ++x)
+		{
+			sums[x] = padded_mines[x] + padded_mines[x + 1] + padded_mines[x + 2];
+		}
+	}
+
+	void VerticalSumScalar(const std::uint8_t* upper, const std::uint8_t* middle, const std::uint8_t* lower, const std::uint8_t* mines, std::uint8_t* counts, std::size_t count)
+	{
+		for (std::size_t x = 0; x < count; ++x)
+		{
+			counts[x] = upper[x] + middle[x] + lower[x] - mines[x];
+		}
+	}
+
+	void PackNibblesScalar(const std::uint8_t* counts, std::uint8_t* packed, std::size_t pairs)
+	{
+		for (std::size_t i = 0; i < pairs; ++i)
+		{
+			packed[i] = static_cast<std::uint8_t>(counts[2 * i] | (counts[2 * i + 1] << 4));
+		}
+	}
+
+#if defined(NEIGHBOUR_COUNT_X86)
+	void HorizontalSumSse2(const std::uint8_t* padded_mines, std::uint8_t* sums, std::size_t count)
+	{
+		for (std::size_t x = 0; x < count; x += 16)
+		{
+			const __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded_mines + x));
+			const __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded_mines + x + 1));
+			const __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded_mines + x + 2));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x), _mm_add_epi8(_mm_add_epi8(left, center), right));
+		}
+	}
+
+	void VerticalSumSse2(const std::uint8_t* upper, const std::uint8_t* middle, const std::uint8_t* lower, const std::uint8_t* mines, std::uint8_t* counts, std::size_t count)
+	{
+		for (std::size_t x = 0; x < count; x += 16)
+		{
+			const __m128i sum = _mm_add_epi8(_mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(upper + x)), 
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(middle + x))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(lower + x)));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(counts + x), _mm_sub_epi8(sum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(mines + x))));
+		}
+	}
+
+	void PackNibblesSse2(const std::uint8_t* counts, std::uint8_t* packed, std::size_t pairs)
+	{
+		const __m128i low_byte_mask = _mm_set1_epi16(0x00FF);
+
+		/* Each 16-bit lane holds one pair: low byte stays, high byte moves down into the upper nibble. */
+		for (std::size_t i = 0; i < pairs; i += 16)
+		{
+			const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counts + 2 * i));
+			const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counts + 2 * i + 16));
+
+			const __m128i first_packed = _mm_or_si128(_mm_and_si128(first, low_byte_mask), _mm_slli_epi16(_mm_srli_epi16(first, 8), 4));
+			const __m128i second_packed = _mm_or_si128(_mm_and_si128(second, low_byte_mask), _mm_slli_epi16(_mm_srli_epi16(second, 8), 4));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(packed + i), _mm_packus_epi16(first_packed, second_packed));
+		}
+	}
+#endif
+
+#if defined(NEIGHBOUR_COUNT_AVX2)
+	NEIGHBOUR_COUNT_TARGET_AVX2
+	void HorizontalSumAvx2(const std::uint8_t* padded_mines, std::uint8_t* sums, std::size_t count)
+	{
+		for (std::size_t x = 0; x < count; x += 32)
+		{
+			const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded_mines + x));
+			const __m256i center = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded_mines + x + 1));
+			const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded_mines + x + 2));
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + x), _mm256_add_epi8(_mm256_add_epi8(left, center), right));
+		}
+	}
+
+	NEIGHBOUR_COUNT_TARGET_AVX2
+	void VerticalSumAvx2(const std::uint8_t* upper, const std::uint8_t* middle, const std::uint8_t* lower, const std::uint8_t* mines, std::uint8_t* counts, std::size_t count)
+	{
+		for (std::size_t x = 0; x < count; x += 32)
+		{
+			const __m256i sum = _mm256_add_epi8(_mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(upper + x)), 
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(middle + x))), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lower + x)));
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(counts + x), _mm256_sub_epi8(sum, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mines + x))));
+		}
+	}
+
+	NEIGHBOUR_COUNT_TARGET_AVX2
+	void PackNibblesAvx2(const std::uint8_t* counts, std::uint8_t* packed, std::size_t pairs)
+	{
+		const __m256i low_byte_mask = _mm256_set1_epi16(0x00FF);
+
+		for (std::size_t i = 0; i < pairs; i += 32)
+		{
+			const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts + 2 * i));
+			const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts + 2 * i + 32));
+
+			const __m256i first_packed = _mm256_or_si256(_mm256_and_si256(first, low_byte_mask), _mm256_slli_epi16(_mm256_srli_epi16(first, 8), 4));
+			const __m256i second_packed = _mm256_or_si256(_mm256_and_si256(second, low_byte_mask), _mm256_slli_epi16(_mm256_srli_epi16(second, 8), 4));
+
+			/* packus works per 128-bit lane, so the 64-bit quarters have to be put back in order. */
+			const __m256i packed_lanes = _mm256_packus_epi16(first_packed, second_packed);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(packed + i), _mm256_permute4x64_epi64(packed_lanes, 0xD8));
+		}
+	}
+#endif
+
+	RowKernels GetRowKernels(SimdLevel simd_level)
+	{
+		switch (simd_level)
+		{
+#if defined(NEIGHBOUR_COUNT_AVX2)
+		case SimdLevel::AVX2:
+			return { HorizontalSumAvx2, VerticalSumAvx2, PackNibblesAvx2 };
+#endif
+#if defined(NEIGHBOUR_COUNT_X86)
+		case SimdLevel::SSE2:
+			return { HorizontalSumSse2, VerticalSumSse2, PackNibblesSse2 };
+#endif
+		default:
+			return { HorizontalSumScalar, VerticalSumScalar, PackNibblesScalar };
+		}
+	}
+} // namespace
+
+SimdLevel GetSupportedSimdLevel()
+{
+#if defined(NEIGHBOUR_COUNT_AVX2)
+	static const SimdLevel supported_level = __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SSE2;
+	return supported_level;
+#elif defined(NEIGHBOUR_COUNT_X86)
+	return SimdLevel::SSE2;
+#else
+	return SimdLevel::SCALAR;
+#endif
+}
+
+void CountNeighbourMines(const BitPlane& mine_plane, int width, int height, NibblePlane& vicinity_plane)
+{
+	CountNeighbourMines(mine_plane, width, height, vicinity_plane, GetSupportedSimdLevel());
+}
+
+void CountNeighbourMines(const BitPlane& mine_plane, int width, int height, NibblePlane& vicinity_plane, SimdLevel simd_level)
+{
+	if (width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	if (simd_level > GetSupportedSimdLevel())
+	{
+		simd_level = GetSupportedSimdLevel();
+	}
+
+	const RowKernels kernels = GetRowKernels(simd_level);
+	const std::size_t row_width = static_cast<std::size_t>(width);
+	const std::size_t row_stride = row_width + 2 * row_padding;
+
+	/* Three rolling rows of unpacked mines (with one zero byte in front) and of horizontal sums. */
+	std::vector<std::uint8_t> buffer(row_stride * 8, 0);
+	std::uint8_t* mine_rows[3] = { buffer.data(), buffer.data() + row_stride, buffer.data() + 2 * row_stride };
+	std::uint8_t* sum_rows[3] = { buffer.data() + 3 * row_stride, buffer.data() + 4 * row_stride, buffer.data() + 5 * row_stride };
+	std::uint8_t* zero_row = buffer.data() + 6 * row_stride;
+	std::uint8_t* counts = buffer.data() + 7 * row_stride;
+	std::vector<std::uint8_t> packed(row_width / 2 + row_padding, 0);
+
+	const auto load_row = [&](int y)
+	{
+		std::uint8_t* mines = mine_rows[y % 3];
+		ExpandRow(mine_plane, static_cast<std::size_t>(y) * row_width, row_width, mines + 1);
+		kernels.horizontal_sum_(mines, sum_rows[y % 3], row_width);
+	};
+
+	std::uint8_t* vicinity_bytes = vicinity_plane.GetBytes();
+
+	load_row(0);
+
+	for (int y = 0; y < height; ++y)
+	{
+		if (y + 1 < height)
+		{
+			load_row(y + 1);
+		}
+
+		const std::uint8_t* upper = y > 0 ? sum_rows[(y - 1) % 3] : zero_row;
+		const std::uint8_t* lower = y + 1 < height ? sum_rows[(y + 1) % 3] : zero_row;
+
+		kernels.vertical_sum_(upper, sum_rows[y % 3], lower, mine_rows[y % 3] + 1, counts, row_width);
+
+		/* Rows of an odd width start on odd cells every other row, those take their first cell separately. */
+		std::size_t index = static_cast<std::size_t>(y) * row_width;
+		const std::uint8_t* row_counts = counts;
+		std::size_t remaining = row_width;
+
+		if (index & 1)
+		{
+			vicinity_plane.Set(index, row_counts[0]);
+			++index;
+			++row_counts;
+			--remaining;
+		}
+
+		const std::size_t pairs = remaining / 2;
+		kernels.pack_nibbles_(row_counts, packed.data(), pairs);
+		std::memcpy(vicinity_bytes + index / 2, packed.data(), pairs);
+
+		if (remaining & 1)
+		{
+			vicinity_plane.Set(index + 2 * pairs, row_counts[remaining - 1]);
+		}
+	}
+}
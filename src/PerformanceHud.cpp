@@ -0,0 +1,172 @@
+#include "PerformanceHud.hpp"
+#include "RenderStats.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+	constexpr int padding = 4;
+	constexpr int graph_height = 32;
+
+	/* One frame at 60 Hz, bars above it are drawn red. */
+	constexpr float frame_budget_milliseconds = 1000.0f / 60.0f;
+
+	/* Full graph height, twice the frame budget. */
+	constexpr float graph_milliseconds = 2.0f * frame_budget_milliseconds;
+
+	void WriteQuad(SDL_Vertex* vertices, float x, float y, float w, float h, const SDL_Color& color)
+	{
+		vertices[0] = { { x, y }, color, { 0.0f, 0.0f } };
+		vertices[1] = { { x + w, y }, color, { 0.0f, 0.0f } };
+		vertices[2] = { { x + w, y + h }, color, { 0.0f, 0.0f } };
+		vertices[3] = { { x, y + h }, color, { 0.0f, 0.0f } };
+	}
+} // namespace
+
+PerformanceHud::PerformanceHud() : 
+	text_renderer_(std::make_unique<TextRenderer>()), 
+	frame_milliseconds_(), 
+	frame_count_(0), 
+	frames_per_second_(0), 
+	ticks_per_second_(0), 
+	draw_calls_(0), 
+	texture_uploads_(0), 
+	vertices_(), 
+	indices_()
+{
+	for (std::size_t quad = 0; quad < quad_count; ++quad)
+	{
+		const int first_vertex = static_cast<int>(quad * 4);
+
+		indices_[quad * 6 + 0] = first_vertex;
+		indices_[quad * 6 + 1] = first_vertex + 1;
+		indices_[quad * 6 + 2] = first_vertex + 2;
+		indices_[quad * 6 + 3] = first_vertex;
+		indices_[quad * 6 + 4] = first_vertex + 2;
+		indices_[quad * 6 + 5] = first_vertex + 3;
+	}
+}
+
+PerformanceHud::~PerformanceHud()
+{
+}
+
+bool PerformanceHud::Load(SDL_Renderer* renderer, TTF_Font* font)
+{
+	return text_renderer_->Load(renderer, font);
+}
+
+void PerformanceHud::RecordFrame(double milliseconds, std::size_t draw_calls, std::size_t texture_uploads)
+{
+	frame_milliseconds_[frame_count_ % window_size] = static_cast<float>(milliseconds);
+	++frame_count_;
+
+	draw_calls_ = draw_calls;
+	texture_uploads_ = texture_uploads;
+}
+
+void PerformanceHud::RecordSecond(int frames, int ticks)
+{
+	frames_per_second_ = frames;
+	ticks_per_second_ = ticks;
+}
+
+void PerformanceHud::GetPercentiles(float* p50, float* p99) const
+{
+	const std::size_t count = std::min(frame_count_, window_size);
+
+	if (count == 0)
+	{
+		*p50 = 0.0f;
+		*p99 = 0.0f;
+		return;
+	}
+
+	/* A copy on the stack, the ring keeps its order for the graph. */
+	std::array<float, window_size> sorted = frame_milliseconds_;
+
+	std::nth_element(sorted.begin(), sorted.begin() + (count - 1) / 2, sorted.begin() + count);
+	*p50 = sorted[(count - 1) / 2];
+
+	std::nth_element(sorted.begin(), sorted.begin() + (count - 1) * 99 / 100, sorted.begin() + count);
+	*p99 = sorted[(count - 1) * 99 / 100];
+}
+
+void PerformanceHud::RenderGraph(SDL_Renderer* renderer, const SDL_Rect& area)
+{
+	const SDL_Color background_color = { 0x00, 0x00, 0x00, 0xC0 };
+	const SDL_Color graph_color = { 0x30, 0x30, 0x30, 0xFF };
+	const SDL_Color budget_color = { 0xE0, 0xE0, 0x40, 0xFF };
+	const SDL_Color fast_color = { 0x40, 0xC0, 0x40, 0xFF };
+	const SDL_Color slow_color = { 0xE0, 0x40, 0x40, 0xFF };
+
+	const float graph_x = static_cast<float>(area.x + area.w - static_cast<int>(window_size) - padding);
+	const float graph_y = static_cast<float>(area.y + area.h - graph_height - padding);
+	const float pixels_per_millisecond = graph_height / graph_milliseconds;
+
+	WriteQuad(&vertices_[0], static_cast<float>(area.x), static_cast<float>(area.y), static_cast<float>(area.w), static_cast<float>(area.h), background_color);
+	WriteQuad(&vertices_[4], graph_x, graph_y, static_cast<float>(window_size), static_cast<float>(graph_height), graph_color);
+	WriteQuad(&vertices_[8], graph_x, graph_y + graph_height - frame_budget_milliseconds * pixels_per_millisecond, static_cast<float>(window_size), 1.0f, budget_color);
+
+	/* Oldest frame on the left. Slots without a frame yet get an empty bar. */
+	const std::size_t count = std::min(frame_count_, window_size);
+
+	for (std::size_t i = 0; i < window_size; ++i)
+	{
+		float milliseconds = 0.0f;
+
+		if (i >= window_size - count)
+		{
+			milliseconds = frame_milliseconds_[(frame_count_ - (window_size - i)) % window_size];
+		}
+
+		const float height = std::min(milliseconds, graph_milliseconds) * pixels_per_millisecond;
+
+		WriteQuad(&vertices_[(i + 3) * 4], graph_x + i, graph_y + graph_height - height, 1.0f, height, 
+			milliseconds > frame_budget_milliseconds ? slow_color : fast_color);
+	}
+
+	/* Untextured geometry blends with the draw blend mode. */
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	SDL_RenderGeometry(renderer, nullptr, vertices_.data(), static_cast<int>(vertices_.size()), indices_.data(), static_cast<int>(indices_.size()));
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	render_stats::CountDrawCall();
+}
+
+void PerformanceHud::Render(SDL_Renderer* renderer, const SDL_Rect& area, std::size_t board_memory)
+{
+	RenderGraph(renderer, area);
+
+	const SDL_Color text_color = { 0xFF, 0xFF, 0xFF, 0xFF };
+	char text[64];
+	int text_width = 0;
+	int line_height = 0;
+
+	text_renderer_->MeasureText("", &text_width, &line_height);
+
+	float p50 = 0.0f;
+	float p99 = 0.0f;
+	GetPercentiles(&p50, &p99);
+
+	int y = area.y + padding;
+
+	snprintf(text, sizeof(text), "%d fps %d tps", frames_per_second_, ticks_per_second_);
+	text_renderer_->DrawText(text, area.x + padding, y, text_color);
+	y += line_height;
+
+	snprintf(text, sizeof(text), "p50 %.2f p99 %.2f ms", p50, p99);
+	text_renderer_->DrawText(text, area.x + padding, y, text_color);
+	y += line_height;
+
+	snprintf(text, sizeof(text), "%zu draws %zu uploads", draw_calls_, texture_uploads_);
+	text_renderer_->DrawText(text, area.x + padding, y, text_color);
+	y += line_height;
+
+	snprintf(text, sizeof(text), "board %.2f MB", board_memory / (1024.0 * 1024.0));
+	text_renderer_->DrawText(text, area.x + padding, y, text_color);
+
+	text_renderer_->Flush(renderer);
+}
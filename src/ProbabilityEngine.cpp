@@ -0,0 +1,779 @@
+#include "ProbabilityEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+	constexpr std::uint32_t not_frontier = UINT32_MAX;
+
+	std::size_t FindRoot(std::vector<std::size_t>& parents, std::size_t node)
+	{
+		while (parents[node] != node)
+		{
+			parents[node] = parents[parents[node]];
+			node = parents[node];
+		}
+
+		return node;
+	}
+
+	std::vector<double> Convolve(const std::vector<double>& a, const std::vector<double>& b)
+	{
+		std::vector<double> result(a.size() + b.size() - 1, 0.0);
+
+		for (std::size_t i = 0; i < a.size(); ++i)
+		{
+			for (std::size_t j = 0; j < b.size(); ++j)
+			{
+				result[i + j] += a[i] * b[j];
+			}
+		}
+
+		return result;
+	}
+
+	/* Scales values so the largest one is 1, which keeps products of many components in range. */
+	void Normalize(std::vector<double>& values)
+	{
+		const double largest = values.empty() ? 0.0 : *std::max_element(values.begin(), values.end());
+
+		if (largest > 0.0)
+		{
+			for (double& value : values)
+			{
+				value /= largest;
+			}
+		}
+	}
+
+	/* Depth-first search over the mine configurations of one component. */
+	class ComponentEnumerator
+	{
+	private:
+		const std::vector<std::vector<int>>& constraint_cells_;
+		const std::vector<int>& constraint_mines_;
+		std::vector<std::vector<int>> cell_constraints_;
+		std::vector<int> order_;
+		std::vector<int> placed_mines_;
+		std::vector<int> unassigned_cells_;
+		std::vector<int> mine_cells_;
+		std::size_t nodes_left_;
+		std::size_t min_mines_;
+		std::size_t mine_range_;
+
+		std::vector<double>& weights_;
+		std::vector<double>& mine_weights_;
+
+		bool Assign(int cell, int mine)
+		{
+			bool valid = true;
+
+			for (int constraint : cell_constraints_[cell])
+			{
+				placed_mines_[constraint] += mine;
+				--unassigned_cells_[constraint];
+
+				valid = valid && placed_mines_[constraint] <= constraint_mines_[constraint] && 
+					placed_mines_[constraint] + unassigned_cells_[constraint] >= constraint_mines_[constraint];
+			}
+
+			return valid;
+		}
+
+		void Unassign(int cell, int mine)
+		{
+			for (int constraint : cell_constraints_[cell])
+			{
+				placed_mines_[constraint] -= mine;
+				++unassigned_cells_[constraint];
+			}
+		}
+
+		bool Search(std::size_t depth)
+		{
+			if (nodes_left_ == 0)
+			{
+				return false;
+			}
+
+			--nodes_left_;
+
+			if (depth == order_.size())
+			{
+				const std::size_t mines = mine_cells_.size();
+
+				weights_[mines] += 1.0;
+
+				for (int cell : mine_cells_)
+				{
+					mine_weights_[cell * mine_range_ + mines - min_mines_] += 1.0;
+				}
+
+				return true;
+			}
+
+			const int cell = order_[depth];
+
+			for (int mine = 0; mine <= 1; ++mine)
+			{
+				if (Assign(cell, mine))
+				{
+					if (mine == 1)
+					{
+						mine_cells_.push_back(cell);
+					}
+
+					const bool completed = Search(depth + 1);
+
+					if (mine == 1)
+					{
+						mine_cells_.pop_back();
+					}
+
+					if (!completed)
+					{
+						Unassign(cell, mine);
+						return false;
+					}
+				}
+
+				Unassign(cell, mine);
+			}
+
+			return true;
+		}
+
+	public:
+		/* Every configuration must hold between min_mines and min_mines + mine_range - 1 mines. */
+		ComponentEnumerator(std::size_t cell_count, const std::vector<std::vector<int>>& constraint_cells, const std::vector<int>& constraint_mines, 
+			std::size_t node_limit, std::size_t min_mines, std::size_t mine_range, std::vector<double>& weights, std::vector<double>& mine_weights) : 
+			constraint_cells_(constraint_cells), 
+			constraint_mines_(constraint_mines), 
+			cell_constraints_(cell_count), 
+			placed_mines_(constraint_cells.size(), 0), 
+			unassigned_cells_(constraint_cells.size(), 0), 
+			nodes_left_(node_limit), 
+			min_mines_(min_mines), 
+			mine_range_(mine_range), 
+			weights_(weights), 
+			mine_weights_(mine_weights)
+		{
+			for (std::size_t constraint = 0; constraint < constraint_cells_.size(); ++constraint)
+			{
+				unassigned_cells_[constraint] = static_cast<int>(constraint_cells_[constraint].size());
+
+				for (int cell : constraint_cells_[constraint])
+				{
+					cell_constraints_[cell].push_back(static_cast<int>(constraint));
+				}
+			}
+
+			/* Visit cells in breadth-first order over shared constraints, so constraints fill up early and prune. */
+			std::vector<bool> visited(cell_count, false);
+
+			for (std::size_t start = 0; start < cell_count; ++start)
+			{
+				if (visited[start])
+				{
+					continue;
+				}
+
+				visited[start] = true;
+				order_.push_back(static_cast<int>(start));
+
+				for (std::size_t next = order_.size() - 1; next < order_.size(); ++next)
+				{
+					for (int constraint : cell_constraints_[order_[next]])
+					{
+						for (int cell : constraint_cells_[constraint])
+						{
+							if (!visited[cell])
+							{
+								visited[cell] = true;
+								order_.push_back(cell);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		/* Returns false if the node limit was reached before every configuration was seen. */
+		bool Run()
+		{
+			return Search(0);
+		}
+	};
+} // namespace
+
+ProbabilityEngine::ProbabilityEngine(ThreadPool* thread_pool) : 
+	thread_pool_(thread_pool), 
+	node_limit_(200000), 
+	exact_(true), 
+	update_exact_(true), 
+	updating_(false), 
+	update_requested_(false)
+{
+}
+
+ProbabilityEngine::~ProbabilityEngine()
+{
+	if (updating_)
+	{
+		thread_pool_->Wait(update_group_);
+	}
+}
+
+void ProbabilityEngine::Update(const Board& board)
+{
+	if (updating_)
+	{
+		thread_pool_->Wait(update_group_);
+		updating_ = false;
+	}
+
+	exact_ = Compute(board, probabilities_);
+}
+
+void ProbabilityEngine::RequestUpdate()
+{
+	update_requested_ = true;
+}
+
+bool ProbabilityEngine::Poll(const Board& board)
+{
+	bool published = false;
+
+	if (updating_ && update_group_.IsDone())
+	{
+		updating_ = false;
+
+		/* The result of a board that has since been replaced by one of another size no longer fits. */
+		if (update_probabilities_.size() == board.GetSize())
+		{
+			probabilities_.swap(update_probabilities_);
+			exact_ = update_exact_;
+			published = true;
+		}
+	}
+
+	/* Until the first update of a board of a new size is done, every unknown cell shows the plain mine density. */
+	if (probabilities_.size() != board.GetSize())
+	{
+		const int unknown_cells = board.GetCoveredSafeCells() + board.GetMines() - board.GetFlagsPlaced();
+		const float density = unknown_cells > 0 ? std::clamp(static_cast<float>(board.GetMinesLeft()) / unknown_cells, 0.0f, 1.0f) : 0.0f;
+
+		probabilities_.assign(board.GetSize(), density);
+
+		for (std::size_t i = 0; i < board.GetSize(); ++i)
+		{
+			if (board.IsFlagged(i) || board.IsUncovered(i))
+			{
+				probabilities_[i] = board.IsFlagged(i) ? 1.0f : 0.0f;
+			}
+		}
+
+		exact_ = false;
+		published = true;
+	}
+
+	if (update_requested_ && !updating_)
+	{
+		update_requested_ = false;
+
+		if (thread_pool_ == nullptr)
+		{
+			exact_ = Compute(board, probabilities_);
+			return true;
+		}
+
+		update_board_ = board;
+		updating_ = true;
+
+		thread_pool_->Submit(update_group_, [this]
+		{
+			update_exact_ = Compute(update_board_, update_probabilities_);
+		});
+	}
+
+	return published;
+}
+
+bool ProbabilityEngine::IsUpdating() const
+{
+	return updating_ || update_requested_;
+}
+
+bool ProbabilityEngine::Compute(const Board& board, std::vector<float>& probabilities)
+{
+	const std::size_t size = board.GetSize();
+
+	probabilities.assign(size, 0.0f);
+
+	if (frontier_ids_.size() != size)
+	{
+		frontier_ids_.assign(size, not_frontier);
+	}
+
+	std::vector<Component> components = BuildComponents(board);
+
+	/* Enumerate the components that are not cached yet, in parallel when there is more than one. */
+	std::map<std::vector<std::uint64_t>, ComponentResult> cache;
+	std::vector<const Component*> missing_components;
+
+	for (const Component& component : components)
+	{
+		const auto cached = cache_.find(component.key_);
+
+		if (cached != cache_.end())
+		{
+			cache.insert(cache_.extract(cached));
+		}
+		else if (cache.find(component.key_) == cache.end())
+		{
+			cache[component.key_];
+			missing_components.push_back(&component);
+		}
+	}
+
+	std::vector<ComponentResult> results(missing_components.size());
+
+	if (thread_pool_ != nullptr && missing_components.size() > 1)
+	{
+		ThreadPool::TaskGroup task_group;
+
+		for (std::size_t i = 0; i < missing_components.size(); ++i)
+		{
+			thread_pool_->Submit(task_group, [this, &results, &missing_components, i]
+			{
+				results[i] = Enumerate(*missing_components[i]);
+			});
+		}
+
+		thread_pool_->Wait(task_group);
+	}
+	else
+	{
+		for (std::size_t i = 0; i < missing_components.size(); ++i)
+		{
+			results[i] = Enumerate(*missing_components[i]);
+		}
+	}
+
+	for (std::size_t i = 0; i < missing_components.size(); ++i)
+	{
+		cache[missing_components[i]->key_] = std::move(results[i]);
+	}
+
+	/* Only the components of the current position are kept. */
+	cache_.swap(cache);
+
+	/* Components that hit the node limit are treated like unconstrained cells. */
+	bool exact = true;
+
+	std::vector<const Component*> exact_components;
+	std::vector<const ComponentResult*> exact_results;
+
+	for (const Component& component : components)
+	{
+		const ComponentResult& result = cache_.at(component.key_);
+
+		if (result.exact_)
+		{
+			exact_components.push_back(&component);
+			exact_results.push_back(&result);
+		}
+		else
+		{
+			exact = false;
+		}
+	}
+
+	int unconstrained_cells = 0;
+
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		if (board.IsFlagged(i))
+		{
+			probabilities[i] = 1.0f;
+		}
+		else if (!board.IsUncovered(i))
+		{
+			++unconstrained_cells;
+		}
+	}
+
+	for (const Component* component : exact_components)
+	{
+		unconstrained_cells -= static_cast<int>(component->cells_.size());
+	}
+
+	const int mines_left = board.GetMinesLeft();
+
+	/* binomial_weights[t]: ways to place t mines among the unconstrained cells, relative to the largest. */
+	std::vector<double> binomial_weights(std::max(mines_left + 1, 1), 0.0);
+	double largest_log_weight = -std::numeric_limits<double>::infinity();
+
+	for (int t = 0; t <= mines_left; ++t)
+	{
+		if (t <= unconstrained_cells)
+		{
+			binomial_weights[t] = std::lgamma(unconstrained_cells + 1.0) - std::lgamma(t + 1.0) - std::lgamma(unconstrained_cells - t + 1.0);
+			largest_log_weight = std::max(largest_log_weight, binomial_weights[t]);
+		}
+	}
+
+	for (int t = 0; t <= mines_left; ++t)
+	{
+		binomial_weights[t] = t <= unconstrained_cells ? std::exp(binomial_weights[t] - largest_log_weight) : 0.0;
+	}
+
+	const auto binomial_weight = [&](long long t)
+	{
+		return t >= 0 && t <= mines_left ? binomial_weights[t] : 0.0;
+	};
+
+	/* prefixes[i] and suffixes[i]: mine count distributions of the components before and from i. */
+	const std::size_t component_count = exact_components.size();
+	std::vector<std::vector<double>> prefixes(component_count + 1, std::vector<double>{ 1.0 });
+	std::vector<std::vector<double>> suffixes(component_count + 1, std::vector<double>{ 1.0 });
+
+	for (std::size_t i = 0; i < component_count; ++i)
+	{
+		prefixes[i + 1] = Convolve(prefixes[i], exact_results[i]->weights_);
+		Normalize(prefixes[i + 1]);
+	}
+
+	for (std::size_t i = component_count; i-- > 0;)
+	{
+		suffixes[i] = Convolve(suffixes[i + 1], exact_results[i]->weights_);
+		Normalize(suffixes[i]);
+	}
+
+	/* Wrong flags can leave no valid configuration, then every unknown cell gets the plain mine density. */
+	bool consistent = true;
+
+	for (std::size_t i = 0; i < component_count; ++i)
+	{
+		const std::vector<double> others = Convolve(prefixes[i], suffixes[i + 1]);
+		const ComponentResult& result = *exact_results[i];
+		const std::size_t cell_count = exact_components[i]->cells_.size();
+
+		/* others_weights[k - min_mines_]: weight of every way to complete the board when this component holds k mines. */
+		const std::size_t mine_range = result.max_mines_ + 1 - result.min_mines_;
+		std::vector<double> others_weights(mine_range, 0.0);
+		double total_weight = 0.0;
+
+		for (std::size_t k = result.min_mines_; k <= result.max_mines_; ++k)
+		{
+			for (std::size_t s = 0; s < others.size(); ++s)
+			{
+				others_weights[k - result.min_mines_] += others[s] * binomial_weight(static_cast<long long>(mines_left) - static_cast<long long>(k + s));
+			}
+
+			total_weight += result.weights_[k] * others_weights[k - result.min_mines_];
+		}
+
+		if (total_weight <= 0.0)
+		{
+			consistent = false;
+			continue;
+		}
+
+		for (std::size_t cell = 0; cell < cell_count; ++cell)
+		{
+			double mine_weight = 0.0;
+
+			for (std::size_t k = 0; k < mine_range; ++k)
+			{
+				mine_weight += result.mine_weights_[cell * mine_range + k] * others_weights[k];
+			}
+
+			probabilities[exact_components[i]->cells_[cell]] = static_cast<float>(mine_weight / total_weight);
+		}
+	}
+
+	/* Each unconstrained cell holds on average (mines left - frontier mines) / unconstrained cells. */
+	double unconstrained_probability = 0.0;
+
+	if (unconstrained_cells > 0)
+	{
+		double total_weight = 0.0;
+		double mine_weight = 0.0;
+
+		for (std::size_t s = 0; s < prefixes[component_count].size(); ++s)
+		{
+			const double weight = prefixes[component_count][s] * binomial_weight(static_cast<long long>(mines_left) - static_cast<long long>(s));
+
+			total_weight += weight;
+			mine_weight += weight * (mines_left - static_cast<double>(s)) / unconstrained_cells;
+		}
+
+		unconstrained_probability = total_weight > 0.0 ? mine_weight / total_weight : 0.0;
+		consistent = consistent && total_weight > 0.0;
+	}
+
+	if (!consistent)
+	{
+		const int unknown_cells = board.GetCoveredSafeCells() + board.GetMines() - board.GetFlagsPlaced();
+		unconstrained_probability = unknown_cells > 0 ? std::clamp(static_cast<double>(mines_left) / unknown_cells, 0.0, 1.0) : 0.0;
+	}
+
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		if (!board.IsFlagged(i) && !board.IsUncovered(i) && frontier_ids_[i] == not_frontier)
+		{
+			probabilities[i] = static_cast<float>(unconstrained_probability);
+		}
+	}
+
+	for (const Component& component : components)
+	{
+		const bool component_exact = cache_.at(component.key_).exact_;
+
+		for (std::size_t cell : component.cells_)
+		{
+			if (!component_exact || !consistent)
+			{
+				probabilities[cell] = static_cast<float>(unconstrained_probability);
+			}
+
+			frontier_ids_[cell] = not_frontier;
+		}
+	}
+
+	return exact;
+}
+
+/* Groups the covered cells next to numbers into components that share no constraint. */
+std::vector<ProbabilityEngine::Component> ProbabilityEngine::BuildComponents(const Board& board)
+{
+	std::vector<std::size_t> frontier_cells;
+	std::vector<std::size_t> constraint_centers;
+	std::vector<int> constraint_mines;
+	std::vector<std::vector<std::uint32_t>> constraint_cells;
+
+	const BitPlane& uncovered_plane = board.GetUncoveredPlane();
+	const std::uint64_t* uncovered_words = uncovered_plane.GetWords();
+
+	for (std::size_t word_index = 0; word_index < uncovered_plane.GetWordCount(); ++word_index)
+	{
+		std::uint64_t word = uncovered_words[word_index];
+
+		while (word != 0)
+		{
+			const std::size_t index = word_index * 64 + __builtin_ctzll(word);
+			word &= word - 1;
+
+			if (board.GetMinesInVicinity(index) == 0 || board.GetState() != BoardState::PLAYING)
+			{
+				continue;
+			}
+
+			int mines = board.GetMinesInVicinity(index);
+			std::vector<std::uint32_t> cells;
+
+			for (std::size_t neighbour_index : board.GetNeighboursIndices(index))
+			{
+				if (board.IsFlagged(neighbour_index))
+				{
+					--mines;
+				}
+				else if (!board.IsUncovered(neighbour_index))
+				{
+					if (frontier_ids_[neighbour_index] == not_frontier)
+					{
+						frontier_ids_[neighbour_index] = static_cast<std::uint32_t>(frontier_cells.size());
+						frontier_cells.push_back(neighbour_index);
+					}
+
+					cells.push_back(frontier_ids_[neighbour_index]);
+				}
+			}
+
+			if (!cells.empty())
+			{
+				constraint_centers.push_back(index);
+				constraint_mines.push_back(mines);
+				constraint_cells.push_back(std::move(cells));
+			}
+		}
+	}
+
+	std::vector<std::size_t> parents(frontier_cells.size());
+	std::iota(parents.begin(), parents.end(), 0);
+
+	for (const std::vector<std::uint32_t>& cells : constraint_cells)
+	{
+		for (std::uint32_t cell : cells)
+		{
+			parents[FindRoot(parents, cell)] = FindRoot(parents, cells.front());
+		}
+	}
+
+	std::vector<Component> components;
+	std::vector<std::size_t> component_of_root(frontier_cells.size(), SIZE_MAX);
+
+	/* Cells are added in board index order, so the cache key does not depend on the order they were found in. */
+	std::vector<std::size_t> sorted_frontier(frontier_cells.size());
+	std::iota(sorted_frontier.begin(), sorted_frontier.end(), 0);
+	std::sort(sorted_frontier.begin(), sorted_frontier.end(), [&frontier_cells](std::size_t a, std::size_t b)
+	{
+		return frontier_cells[a] < frontier_cells[b];
+	});
+
+	std::vector<int> local_ids(frontier_cells.size(), 0);
+
+	for (std::size_t frontier_id : sorted_frontier)
+	{
+		const std::size_t root = FindRoot(parents, frontier_id);
+
+		if (component_of_root[root] == SIZE_MAX)
+		{
+			component_of_root[root] = components.size();
+			components.emplace_back();
+		}
+
+		Component& component = components[component_of_root[root]];
+		local_ids[frontier_id] = static_cast<int>(component.cells_.size());
+		component.cells_.push_back(frontier_cells[frontier_id]);
+		component.key_.push_back(frontier_cells[frontier_id]);
+	}
+
+	for (Component& component : components)
+	{
+		component.key_.push_back(UINT64_MAX);
+	}
+
+	for (std::size_t constraint = 0; constraint < constraint_cells.size(); ++constraint)
+	{
+		Component& component = components[component_of_root[FindRoot(parents, constraint_cells[constraint].front())]];
+
+		std::vector<int> cells;
+
+		for (std::uint32_t cell : constraint_cells[constraint])
+		{
+			cells.push_back(local_ids[cell]);
+		}
+
+		component.constraint_cells_.push_back(std::move(cells));
+		component.constraint_mines_.push_back(constraint_mines[constraint]);
+		component.key_.push_back((static_cast<std::uint64_t>(constraint_centers[constraint]) << 4) | static_cast<std::uint64_t>(constraint_mines[constraint] & 0x0F));
+	}
+
+	return components;
+}
+
+ProbabilityEngine::ComponentResult ProbabilityEngine::Enumerate(const Component& component) const
+{
+	const std::size_t cell_count = component.cells_.size();
+
+	/* Every cell is next to a constraint and every configuration meets them all, so a configuration holds at least 
+	 * the mines of the fullest constraint and at most the mines of all of them together. */
+	int largest_constraint = 0;
+	int constraint_sum = 0;
+
+	for (int mines : component.constraint_mines_)
+	{
+		largest_constraint = std::max(largest_constraint, mines);
+		constraint_sum += mines;
+	}
+
+	const std::size_t bound_min = static_cast<std::size_t>(largest_constraint);
+	const std::size_t bound_max = std::max(std::min(static_cast<std::size_t>(std::max(constraint_sum, 0)), cell_count), bound_min);
+	const std::size_t bound_range = bound_max + 1 - bound_min;
+
+	ComponentResult result;
+	result.weights_.assign(cell_count + 1, 0.0);
+	result.mine_weights_.assign(cell_count * bound_range, 0.0);
+
+	ComponentEnumerator enumerator(cell_count, component.constraint_cells_, component.constraint_mines_, node_limit_, bound_min, bound_range, 
+		result.weights_, result.mine_weights_);
+	result.exact_ = enumerator.Run();
+
+	/* Only the mine counts that occurred are kept, an empty range when no configuration was valid. */
+	result.min_mines_ = 1;
+	result.max_mines_ = 0;
+
+	for (std::size_t k = bound_min; k <= std::min(bound_max, cell_count); ++k)
+	{
+		if (result.weights_[k] > 0.0)
+		{
+			if (result.min_mines_ > result.max_mines_)
+			{
+				result.min_mines_ = k;
+			}
+
+			result.max_mines_ = k;
+		}
+	}
+
+	const std::size_t mine_range = result.max_mines_ + 1 - result.min_mines_;
+
+	if (mine_range == 0)
+	{
+		result.mine_weights_.clear();
+	}
+	else if (mine_range != bound_range)
+	{
+		std::vector<double> mine_weights(cell_count * mine_range);
+
+		for (std::size_t cell = 0; cell < cell_count; ++cell)
+		{
+			const auto first = result.mine_weights_.begin() + cell * bound_range + (result.min_mines_ - bound_min);
+			std::copy(first, first + mine_range, mine_weights.begin() + cell * mine_range);
+		}
+
+		result.mine_weights_.swap(mine_weights);
+	}
+
+	const double largest = *std::max_element(result.weights_.begin(), result.weights_.end());
+
+	if (largest > 0.0)
+	{
+		for (double& weight : result.weights_)
+		{
+			weight /= largest;
+		}
+
+		for (double& weight : result.mine_weights_)
+		{
+			weight /= largest;
+		}
+	}
+
+	return result;
+}
+
+float ProbabilityEngine::GetMineProbability(std::size_t index) const
+{
+	return probabilities_[index];
+}
+
+const std::vector<float>& ProbabilityEngine::GetProbabilities() const
+{
+	return probabilities_;
+}
+
+bool ProbabilityEngine::IsExact() const
+{
+	return exact_;
+}
+
+std::size_t ProbabilityEngine::GetCachedComponentCount() const
+{
+	return cache_.size();
+}
+
+void ProbabilityEngine::SetNodeLimit(std::size_t node_limit)
+{
+	node_limit_ = node_limit;
+}
@@ -0,0 +1,121 @@
+#include "Profiler.hpp"
+
+#ifdef MINESWEEPER_PROFILE
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	/* About 1.5 MB per thread, several seconds of frames. */
+	constexpr std::size_t ring_capacity = std::size_t{ 1 } << 16;
+
+	struct ZoneRecord
+	{
+		const char* name_;
+		std::uint64_t start_;
+		std::uint64_t end_;
+	};
+
+	/* Only the owning thread writes. head_ counts every zone ever recorded, readers take the newest 
+	 * ring_capacity of them. A zone overwritten while a trace is being written can come out torn, which is 
+	 * acceptable for a debugging aid and keeps recording free of locks. */
+	struct ThreadBuffer
+	{
+		std::array<ZoneRecord, ring_capacity> records_;
+		std::atomic<std::uint64_t> head_;
+		std::size_t thread_id_;
+	};
+
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+	/* Buffers stay alive after their thread exits so their zones still make it into the trace. */
+	std::mutex registry_mutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+	thread_local ThreadBuffer* thread_buffer = nullptr;
+
+	ThreadBuffer* RegisterThread()
+	{
+		const std::lock_guard<std::mutex> lock(registry_mutex);
+
+		registry.push_back(std::make_unique<ThreadBuffer>());
+		registry.back()->head_.store(0, std::memory_order_relaxed);
+		registry.back()->thread_id_ = registry.size();
+
+		return registry.back().get();
+	}
+} // namespace
+
+namespace profiler
+{
+	std::uint64_t Now()
+	{
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+	}
+
+	void Record(const char* name, std::uint64_t start, std::uint64_t end)
+	{
+		if (thread_buffer == nullptr)
+		{
+			thread_buffer = RegisterThread();
+		}
+
+		const std::uint64_t head = thread_buffer->head_.load(std::memory_order_relaxed);
+
+		thread_buffer->records_[head & (ring_capacity - 1)] = { name, start, end };
+		thread_buffer->head_.store(head + 1, std::memory_order_release);
+	}
+
+	bool WriteTrace(const char* path)
+	{
+		FILE* file = std::fopen(path, "w");
+
+		if (file == nullptr)
+		{
+			printf("Unable to write the trace to %s!\n", path);
+			return false;
+		}
+
+		std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+		const std::lock_guard<std::mutex> lock(registry_mutex);
+		bool first_event = true;
+
+		for (const std::unique_ptr<ThreadBuffer>& buffer : registry)
+		{
+			const std::uint64_t head = buffer->head_.load(std::memory_order_acquire);
+			const std::uint64_t first = head > ring_capacity ? head - ring_capacity : 0;
+
+			for (std::uint64_t i = first; i < head; ++i)
+			{
+				const ZoneRecord& record = buffer->records_[i & (ring_capacity - 1)];
+
+				/* Chrome traces are in microseconds. */
+				std::fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}", 
+					first_event ? "" : ",", record.name_, buffer->thread_id_, record.start_ / 1000.0, (record.end_ - record.start_) / 1000.0);
+				first_event = false;
+			}
+		}
+
+		std::fprintf(file, "\n]}\n");
+
+		const bool written = std::fclose(file) == 0;
+
+		if (written)
+		{
+			printf("Wrote the profiling trace to %s\n", path);
+		}
+
+		return written;
+	}
+} // namespace profiler
+
+#endif
@@ -0,0 +1,234 @@
+#include "Replay.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	constexpr char magic[4] = { 'M', 'S', 'R', 'P' };
+	constexpr std::uint8_t version = 1;
+
+	constexpr std::size_t buffer_capacity = 4096;
+} // namespace
+
+ReplayWriter::ReplayWriter() : 
+	file_(nullptr)
+{
+	buffer_.reserve(buffer_capacity);
+}
+
+ReplayWriter::~ReplayWriter()
+{
+	Close();
+}
+
+bool ReplayWriter::Open(const char* path)
+{
+	Close();
+
+	file_ = std::fopen(path, "ab");
+
+	if (file_ == nullptr)
+	{
+		printf("Unable to open the replay log %s!\n", path);
+		return false;
+	}
+
+	std::fseek(file_, 0, SEEK_END);
+
+	if (std::ftell(file_) == 0)
+	{
+		buffer_.insert(buffer_.end(), magic, magic + sizeof(magic));
+		buffer_.push_back(version);
+		Flush();
+	}
+
+	return true;
+}
+
+void ReplayWriter::Close()
+{
+	if (file_ == nullptr)
+	{
+		return;
+	}
+
+	Flush();
+	std::fclose(file_);
+	file_ = nullptr;
+}
+
+bool ReplayWriter::IsOpen() const
+{
+	return file_ != nullptr;
+}
+
+void ReplayWriter::WriteVarint(std::uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		buffer_.push_back(static_cast<std::uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+
+	buffer_.push_back(static_cast<std::uint8_t>(value));
+}
+
+void ReplayWriter::BeginGame(const ReplayGame& game)
+{
+	buffer_.push_back(static_cast<std::uint8_t>(ReplayAction::NEW_GAME));
+	WriteVarint(game.seed_);
+	WriteVarint(static_cast<std::uint64_t>(game.width_));
+	WriteVarint(static_cast<std::uint64_t>(game.height_));
+	WriteVarint(static_cast<std::uint64_t>(game.mines_));
+	buffer_.push_back(game.no_guess_ ? 1 : 0);
+}
+
+void ReplayWriter::WriteEvent(ReplayAction action, std::uint64_t ticks, std::size_t cell)
+{
+	buffer_.push_back(static_cast<std::uint8_t>(action));
+	WriteVarint(ticks);
+	WriteVarint(cell);
+
+	if (buffer_.size() >= buffer_capacity)
+	{
+		Flush();
+	}
+}
+
+void ReplayWriter::Flush()
+{
+	if (file_ == nullptr || buffer_.empty())
+	{
+		return;
+	}
+
+	if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size() || std::fflush(file_) != 0)
+	{
+		printf("Unable to write the replay log!\n");
+	}
+
+	buffer_.clear();
+}
+
+ReplayReader::ReplayReader() : 
+	position_(0)
+{
+}
+
+ReplayReader::~ReplayReader()
+{
+}
+
+bool ReplayReader::Open(const char* path)
+{
+	data_.clear();
+	position_ = 0;
+
+	FILE* file = std::fopen(path, "rb");
+
+	if (file == nullptr)
+	{
+		printf("Unable to open the replay log %s!\n", path);
+		return false;
+	}
+
+	std::uint8_t chunk[65536];
+	std::size_t read = 0;
+
+	while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+	{
+		data_.insert(data_.end(), chunk, chunk + read);
+	}
+
+	std::fclose(file);
+
+	if (data_.size() < sizeof(magic) + 1 || std::memcmp(data_.data(), magic, sizeof(magic)) != 0 || data_[sizeof(magic)] != version)
+	{
+		printf("%s is not a replay log of version %d!\n", path, version);
+		data_.clear();
+		return false;
+	}
+
+	position_ = sizeof(magic) + 1;
+	return true;
+}
+
+bool ReplayReader::ReadVarint(std::uint64_t* value)
+{
+	std::uint64_t result = 0;
+
+	for (int shift = 0; shift < 64 && position_ < data_.size(); shift += 7)
+	{
+		const std::uint8_t byte = data_[position_++];
+
+		result |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+		if ((byte & 0x80) == 0)
+		{
+			*value = result;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ReplayReader::Next(ReplayRecord* record)
+{
+	if (position_ >= data_.size())
+	{
+		return false;
+	}
+
+	const std::uint8_t action = data_[position_++];
+
+	if (action == static_cast<std::uint8_t>(ReplayAction::NEW_GAME))
+	{
+		std::uint64_t seed = 0;
+		std::uint64_t width = 0;
+		std::uint64_t height = 0;
+		std::uint64_t mines = 0;
+
+		if (!ReadVarint(&seed) || !ReadVarint(&width) || !ReadVarint(&height) || !ReadVarint(&mines) || position_ >= data_.size())
+		{
+			return false;
+		}
+
+		/* Boards count their cells in int, so anything larger cannot have been recorded. */
+		constexpr std::uint64_t max_cells = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+
+		if (width == 0 || height == 0 || width > max_cells || height > max_cells / width || mines > width * height)
+		{
+			return false;
+		}
+
+		record->action_ = ReplayAction::NEW_GAME;
+		record->game_ = { seed, static_cast<int>(width), static_cast<int>(height), static_cast<int>(mines), data_[position_++] != 0 };
+		record->ticks_ = 0;
+		record->cell_ = 0;
+		return true;
+	}
+
+	if (action > static_cast<std::uint8_t>(ReplayAction::FLAG))
+	{
+		return false;
+	}
+
+	std::uint64_t ticks = 0;
+	std::uint64_t cell = 0;
+
+	if (!ReadVarint(&ticks) || !ReadVarint(&cell))
+	{
+		return false;
+	}
+
+	record->action_ = static_cast<ReplayAction>(action);
+	record->ticks_ = ticks;
+	record->cell_ = static_cast<std::size_t>(cell);
+	return true;
+}
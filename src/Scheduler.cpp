@@ -0,0 +1,111 @@
+#include "Scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+Scheduler::Scheduler() : 
+	frequency_(1), 
+	tick_rate_(1), 
+	time_(0), 
+	ticks_(0)
+{
+}
+
+Scheduler::~Scheduler()
+{
+}
+
+std::uint64_t Scheduler::GetTickTime(std::uint64_t tick) const
+{
+	/* Split into whole seconds and the remainder so the products cannot overflow. Rounded up, the tick is due 
+	 * once the time has fully reached it. */
+	const std::uint64_t seconds = tick / tick_rate_;
+	const std::uint64_t remainder = tick % tick_rate_;
+
+	return seconds * frequency_ + (remainder * frequency_ + tick_rate_ - 1) / tick_rate_;
+}
+
+std::uint64_t Scheduler::GetTicksDue() const
+{
+	const std::uint64_t seconds = time_ / frequency_;
+	const std::uint64_t remainder = time_ % frequency_;
+
+	return seconds * tick_rate_ + remainder * tick_rate_ / frequency_;
+}
+
+void Scheduler::Reset(std::uint64_t frequency, std::uint64_t tick_rate)
+{
+	frequency_ = std::max<std::uint64_t>(frequency, 1);
+	tick_rate_ = std::max<std::uint64_t>(tick_rate, 1);
+	time_ = 0;
+	ticks_ = 0;
+}
+
+void Scheduler::SetTime(std::uint64_t time)
+{
+	time_ = std::max(time_, time);
+}
+
+void Scheduler::Advance(std::uint64_t duration)
+{
+	time_ += duration;
+}
+
+void Scheduler::AdvanceToNextTick()
+{
+	SetTime(GetTickTime(ticks_ + 1));
+}
+
+bool Scheduler::ConsumeTick()
+{
+	if (ticks_ >= GetTicksDue())
+	{
+		return false;
+	}
+
+	++ticks_;
+	return true;
+}
+
+void Scheduler::DropPendingTicks(std::uint64_t max_pending)
+{
+	const std::uint64_t ticks_due = GetTicksDue();
+
+	if (ticks_due > ticks_ + max_pending)
+	{
+		ticks_ = ticks_due - max_pending;
+	}
+}
+
+std::uint64_t Scheduler::GetTime() const
+{
+	return time_;
+}
+
+std::uint64_t Scheduler::GetTicks() const
+{
+	return ticks_;
+}
+
+std::uint64_t Scheduler::GetFrequency() const
+{
+	return frequency_;
+}
+
+std::uint64_t Scheduler::GetTimeToNextTick() const
+{
+	const std::uint64_t next_tick_time = GetTickTime(ticks_ + 1);
+
+	return next_tick_time > time_ ? next_tick_time - time_ : 0;
+}
+
+double Scheduler::ToSeconds(std::uint64_t duration) const
+{
+	return static_cast<double>(duration) / static_cast<double>(frequency_);
+}
+
+std::uint64_t Scheduler::FromSeconds(double seconds) const
+{
+	return static_cast<std::uint64_t>(std::llround(seconds * static_cast<double>(frequency_)));
+}
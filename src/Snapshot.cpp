@@ -0,0 +1,382 @@
+#include "Snapshot.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+	constexpr char magic[4] = { 'M', 'S', 'S', 'V' };
+	constexpr std::uint32_t version = 1;
+	constexpr std::uint32_t byte_order_marker = 0x01020304;
+	constexpr std::uint64_t plane_alignment = 64;
+
+	/* On-disk header, fixed-width fields only. */
+	struct SnapshotHeader
+	{
+		char magic_[4];
+		std::uint32_t version_;
+		std::uint32_t byte_order_marker_;
+		std::uint32_t header_size_;
+
+		std::int32_t width_;
+		std::int32_t height_;
+		std::int32_t mines_;
+		std::int32_t flags_placed_;
+		std::int32_t covered_safe_cells_;
+		std::uint8_t mines_placed_;
+		std::uint8_t state_;
+		std::uint8_t game_started_;
+		std::uint8_t no_guess_;
+
+		std::uint64_t seed_;
+		std::uint64_t exploded_index_;
+		std::uint64_t elapsed_microseconds_;
+
+		std::uint64_t mine_offset_;
+		std::uint64_t uncovered_offset_;
+		std::uint64_t flag_offset_;
+		std::uint64_t vicinity_offset_;
+		std::uint64_t file_size_;
+	};
+
+	static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "the snapshot header is written as raw bytes");
+	static_assert(sizeof(SnapshotHeader) == 104, "the snapshot header layout changed, bump the version");
+
+	std::uint64_t AlignUp(std::uint64_t offset)
+	{
+		return (offset + plane_alignment - 1) / plane_alignment * plane_alignment;
+	}
+
+	std::uint64_t GetWordBytes(std::uint64_t cells)
+	{
+		return (cells + 63) / 64 * sizeof(std::uint64_t);
+	}
+
+	std::uint64_t GetNibbleBytes(std::uint64_t cells)
+	{
+		return (cells + 1) / 2;
+	}
+
+	/* Writes all of iov, continuing after partial writes. */
+	bool WriteFully(int file, iovec* iov, int count)
+	{
+		while (count > 0)
+		{
+			const ssize_t written = writev(file, iov, count);
+
+			if (written < 0)
+			{
+				return false;
+			}
+
+			std::size_t remaining = static_cast<std::size_t>(written);
+
+			while (count > 0 && remaining >= iov->iov_len)
+			{
+				remaining -= iov->iov_len;
+				++iov;
+				--count;
+			}
+
+			if (count > 0)
+			{
+				iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+				iov->iov_len -= remaining;
+			}
+		}
+
+		return true;
+	}
+
+	/* Moves from over to, leaving the old to at from when the system can swap files atomically. */
+	bool ReplaceFile(const char* from, const char* to)
+	{
+#ifdef RENAME_EXCHANGE
+		if (renameat2(AT_FDCWD, from, AT_FDCWD, to, RENAME_EXCHANGE) == 0)
+		{
+			return true;
+		}
+#endif
+
+		return std::rename(from, to) == 0;
+	}
+
+	bool IsHeaderValid(const SnapshotHeader& header, std::uint64_t file_size)
+	{
+		if (std::memcmp(header.magic_, magic, sizeof(magic)) != 0 || header.version_ != version || 
+			header.byte_order_marker_ != byte_order_marker || header.header_size_ != sizeof(SnapshotHeader) || header.file_size_ != file_size)
+		{
+			return false;
+		}
+
+		if (header.width_ <= 0 || header.height_ <= 0 || header.mines_ < 0 || header.state_ > static_cast<std::uint8_t>(BoardState::LOST))
+		{
+			return false;
+		}
+
+		const std::uint64_t cells = static_cast<std::uint64_t>(header.width_) * static_cast<std::uint64_t>(header.height_);
+
+		/* Boards count their cells in int. */
+		if (cells > static_cast<std::uint64_t>(std::numeric_limits<int>::max()) || static_cast<std::uint64_t>(header.mines_) > cells)
+		{
+			return false;
+		}
+
+		const std::array<std::pair<std::uint64_t, std::uint64_t>, 4> planes = { {
+			{ header.mine_offset_, GetWordBytes(cells) }, 
+			{ header.uncovered_offset_, GetWordBytes(cells) }, 
+			{ header.flag_offset_, GetWordBytes(cells) }, 
+			{ header.vicinity_offset_, GetNibbleBytes(cells) }
+		} };
+
+		for (const std::pair<std::uint64_t, std::uint64_t>& plane : planes)
+		{
+			if (plane.first % plane_alignment != 0 || plane.first < sizeof(SnapshotHeader) || plane.first > file_size || plane.second > file_size - plane.first)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/* Portable popcount that the compiler inlines, without -mpopcnt std::bitset::count is a library call. */
+	std::size_t CountBits(std::uint64_t word)
+	{
+		word = word - ((word >> 1) & 0x5555555555555555);
+		word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+		word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0F;
+
+		return static_cast<std::size_t>((word * 0x0101010101010101) >> 56);
+	}
+
+	/* Checks the counters and state against the planes, so a damaged file cannot restore a board that never 
+	 * ends or ends on the next click. These hold after every board operation: flagged cells are never 
+	 * uncovered, mines are only uncovered by losing, and winning flags exactly the mines. */
+	bool IsImageConsistent(const BoardImage& image)
+	{
+		const std::size_t cells = static_cast<std::size_t>(image.width_) * static_cast<std::size_t>(image.height_);
+		const std::size_t word_count = (cells + 63) / 64;
+		const std::uint64_t tail_mask = (cells & 63) == 0 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << (cells & 63)) - 1;
+
+		std::size_t mines = 0;
+		std::size_t flags = 0;
+		std::size_t uncovered_safe_cells = 0;
+		std::uint64_t uncovered_mines = 0;
+		std::uint64_t flagged_and_uncovered = 0;
+
+		for (std::size_t i = 0; i < word_count; ++i)
+		{
+			const std::uint64_t mask = i + 1 == word_count ? tail_mask : ~std::uint64_t{ 0 };
+			const std::uint64_t mine_word = image.mine_words_[i] & mask;
+			const std::uint64_t uncovered_word = image.uncovered_words_[i] & mask;
+			const std::uint64_t flag_word = image.flag_words_[i] & mask;
+
+			mines += CountBits(mine_word);
+			flags += CountBits(flag_word);
+			uncovered_safe_cells += CountBits(uncovered_word & ~mine_word);
+			uncovered_mines |= uncovered_word & mine_word;
+			flagged_and_uncovered |= flag_word & uncovered_word;
+		}
+
+		/* A nibble is above 8 when its top bit and any of its low bits are set. Adding 7 to the low bits carries 
+		 * into the top bit exactly when one of them is set, and never out of the nibble. */
+		constexpr std::uint64_t low_bits = 0x7777777777777777;
+		constexpr std::uint64_t top_bits = 0x8888888888888888;
+		const std::size_t vicinity_size = (cells + 1) / 2;
+		std::uint64_t too_many_neighbours = 0;
+
+		std::size_t i = 0;
+
+		for (; i + sizeof(std::uint64_t) <= vicinity_size; i += sizeof(std::uint64_t))
+		{
+			std::uint64_t word;
+			std::memcpy(&word, image.vicinity_bytes_ + i, sizeof(std::uint64_t));
+
+			too_many_neighbours |= word & ((word & low_bits) + low_bits) & top_bits;
+		}
+
+		std::uint64_t tail = 0;
+		std::memcpy(&tail, image.vicinity_bytes_ + i, vicinity_size - i);
+		too_many_neighbours |= tail & ((tail & low_bits) + low_bits) & top_bits;
+
+		if (too_many_neighbours != 0)
+		{
+			return false;
+		}
+
+		const std::size_t expected_mines = image.mines_placed_ ? static_cast<std::size_t>(image.mines_) : 0;
+		const std::size_t covered_safe_cells = cells - image.mines_ - uncovered_safe_cells;
+
+		if (mines != expected_mines || flags != static_cast<std::size_t>(image.flags_placed_) || flagged_and_uncovered != 0 || 
+			covered_safe_cells != static_cast<std::size_t>(image.covered_safe_cells_))
+		{
+			return false;
+		}
+
+		if (!image.mines_placed_ && (uncovered_safe_cells != 0 || image.state_ != BoardState::PLAYING))
+		{
+			return false;
+		}
+
+		switch (image.state_)
+		{
+		case BoardState::PLAYING:
+			return uncovered_mines == 0 && image.exploded_index_ == cells && (covered_safe_cells > 0 || !image.mines_placed_);
+		case BoardState::WON:
+			return uncovered_mines == 0 && image.exploded_index_ == cells && covered_safe_cells == 0 && flags == mines;
+		case BoardState::LOST:
+			return image.exploded_index_ < cells && (image.mine_words_[image.exploded_index_ >> 6] >> (image.exploded_index_ & 63) & 1) != 0 && 
+				(image.uncovered_words_[image.exploded_index_ >> 6] >> (image.exploded_index_ & 63) & 1) != 0;
+		}
+
+		return false;
+	}
+} // namespace
+
+bool SaveSnapshot(const char* path, const Board& board, const SnapshotInfo& info)
+{
+	const BoardImage image = board.GetImage();
+	const std::uint64_t cells = board.GetSize();
+
+	SnapshotHeader header = {};
+	std::memcpy(header.magic_, magic, sizeof(magic));
+	header.version_ = version;
+	header.byte_order_marker_ = byte_order_marker;
+	header.header_size_ = sizeof(SnapshotHeader);
+	header.width_ = image.width_;
+	header.height_ = image.height_;
+	header.mines_ = image.mines_;
+	header.flags_placed_ = image.flags_placed_;
+	header.covered_safe_cells_ = image.covered_safe_cells_;
+	header.mines_placed_ = image.mines_placed_ ? 1 : 0;
+	header.state_ = static_cast<std::uint8_t>(image.state_);
+	header.game_started_ = info.game_started_ ? 1 : 0;
+	header.no_guess_ = info.no_guess_ ? 1 : 0;
+	header.seed_ = image.seed_;
+	header.exploded_index_ = image.exploded_index_;
+	header.elapsed_microseconds_ = info.elapsed_microseconds_;
+	header.mine_offset_ = AlignUp(sizeof(SnapshotHeader));
+	header.uncovered_offset_ = AlignUp(header.mine_offset_ + GetWordBytes(cells));
+	header.flag_offset_ = AlignUp(header.uncovered_offset_ + GetWordBytes(cells));
+	header.vicinity_offset_ = AlignUp(header.flag_offset_ + GetWordBytes(cells));
+	header.file_size_ = header.vicinity_offset_ + GetNibbleBytes(cells);
+
+	/* Word planes are a multiple of 8 bytes, so padding to the next plane is always less than this. */
+	static const std::array<std::uint8_t, plane_alignment> padding = {};
+
+	iovec iov[8] = {
+		{ &header, sizeof(SnapshotHeader) }, 
+		{ const_cast<std::uint8_t*>(padding.data()), header.mine_offset_ - sizeof(SnapshotHeader) }, 
+		{ const_cast<std::uint64_t*>(image.mine_words_), GetWordBytes(cells) }, 
+		{ const_cast<std::uint8_t*>(padding.data()), header.uncovered_offset_ - header.mine_offset_ - GetWordBytes(cells) }, 
+		{ const_cast<std::uint64_t*>(image.uncovered_words_), GetWordBytes(cells) }, 
+		{ const_cast<std::uint8_t*>(padding.data()), header.flag_offset_ - header.uncovered_offset_ - GetWordBytes(cells) }, 
+		{ const_cast<std::uint64_t*>(image.flag_words_), GetWordBytes(cells) }, 
+		{ const_cast<std::uint8_t*>(padding.data()), header.vicinity_offset_ - header.flag_offset_ - GetWordBytes(cells) }
+	};
+
+	/* Written next to the current snapshot, synced to disk and only then swapped with it, so neither a crash nor 
+	 * a power loss leaves a half written save. The previous snapshot becomes the next temporary file and is 
+	 * overwritten in place, which is several times faster than writing a new file. */
+	const std::string temporary_path = std::string(path) + ".tmp";
+	const int file = open(temporary_path.c_str(), O_WRONLY | O_CREAT, 0644);
+
+	if (file < 0)
+	{
+		printf("Unable to write the snapshot %s!\n", temporary_path.c_str());
+		return false;
+	}
+
+	iovec vicinity = { const_cast<std::uint8_t*>(image.vicinity_bytes_), GetNibbleBytes(cells) };
+	const bool written = WriteFully(file, iov, 8) && WriteFully(file, &vicinity, 1) && ftruncate(file, static_cast<off_t>(header.file_size_)) == 0 && 
+		fdatasync(file) == 0;
+
+	if (close(file) != 0 || !written || !ReplaceFile(temporary_path.c_str(), path))
+	{
+		printf("Unable to write the snapshot %s!\n", path);
+		std::remove(temporary_path.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool LoadSnapshot(const char* path, Board& board, SnapshotInfo* info)
+{
+	const int file = open(path, O_RDONLY);
+
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat file_status = {};
+
+	if (fstat(file, &file_status) != 0 || static_cast<std::uint64_t>(file_status.st_size) < sizeof(SnapshotHeader))
+	{
+		close(file);
+		printf("%s is not a snapshot!\n", path);
+		return false;
+	}
+
+	const std::size_t file_size = static_cast<std::size_t>(file_status.st_size);
+	void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (mapping == MAP_FAILED)
+	{
+		printf("Unable to map the snapshot %s!\n", path);
+		return false;
+	}
+
+	const std::uint8_t* bytes = static_cast<const std::uint8_t*>(mapping);
+	SnapshotHeader header;
+	std::memcpy(&header, bytes, sizeof(SnapshotHeader));
+
+	bool valid = IsHeaderValid(header, file_size);
+
+	if (valid)
+	{
+		const BoardImage image = { 
+			header.width_, header.height_, header.mines_, header.flags_placed_, header.covered_safe_cells_, header.mines_placed_ != 0, 
+			header.seed_, static_cast<BoardState>(header.state_), static_cast<std::size_t>(header.exploded_index_), 
+			reinterpret_cast<const std::uint64_t*>(bytes + header.mine_offset_), 
+			reinterpret_cast<const std::uint64_t*>(bytes + header.uncovered_offset_), 
+			reinterpret_cast<const std::uint64_t*>(bytes + header.flag_offset_), 
+			bytes + header.vicinity_offset_ 
+		};
+
+		valid = IsImageConsistent(image);
+
+		if (valid)
+		{
+			board.Restore(image);
+			*info = { header.elapsed_microseconds_, header.game_started_ != 0, header.no_guess_ != 0 };
+		}
+		else
+		{
+			printf("%s is damaged, its board does not add up!\n", path);
+		}
+	}
+	else
+	{
+		printf("%s is not a snapshot of version %u!\n", path, version);
+	}
+
+	munmap(mapping, file_size);
+	return valid;
+}
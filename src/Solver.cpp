@@ -0,0 +1,434 @@
+#include "Solver.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	constexpr int window_size = 7;
+	constexpr int window_center = 3;
+	constexpr std::uint32_t no_constraint = UINT32_MAX;
+
+	int CountBits(std::uint64_t mask)
+	{
+		return static_cast<int>(std::bitset<64>(mask).count());
+	}
+
+	int GetWindowBit(int dx, int dy)
+	{
+		return (window_center + dy) * window_size + window_center + dx;
+	}
+
+	/* Moves a mask from the window of one cell into the window of a cell (dx, dy) away from it. */
+	std::uint64_t ShiftWindow(std::uint64_t mask, int dx, int dy)
+	{
+		const int shift = dy * window_size + dx;
+		return shift >= 0 ? mask << shift : mask >> -shift;
+	}
+} // namespace
+
+Solver::Solver() : 
+	layout_id_(0)
+{
+}
+
+Solver::~Solver()
+{
+}
+
+bool Solver::FindForcedCells(const Board& board)
+{
+	Prepare(board);
+
+	if (board.GetState() != BoardState::PLAYING)
+	{
+		return false;
+	}
+
+	UpdateConstraints(board);
+
+	ApplySinglePointRule(board);
+
+	if (safe_cells_.empty() && mine_cells_.empty())
+	{
+		ApplyPairRules(board);
+	}
+
+	if (safe_cells_.empty() && mine_cells_.empty())
+	{
+		ApplyMineCounterRule(board);
+	}
+
+	return !safe_cells_.empty() || !mine_cells_.empty();
+}
+
+const std::vector<std::size_t>& Solver::GetSafeCells() const
+{
+	return safe_cells_;
+}
+
+const std::vector<std::size_t>& Solver::GetMineCells() const
+{
+	return mine_cells_;
+}
+
+bool Solver::IsForcedSafe(std::size_t index) const
+{
+	return forced_safe_plane_.Get(index);
+}
+
+bool Solver::IsForcedMine(std::size_t index) const
+{
+	return forced_mine_plane_.Get(index);
+}
+
+bool Solver::GetHint(const Board& board, std::size_t* index, bool* is_mine)
+{
+	if (!FindForcedCells(board))
+	{
+		return false;
+	}
+
+	*is_mine = safe_cells_.empty();
+	*index = *is_mine ? mine_cells_.front() : safe_cells_.front();
+
+	return true;
+}
+
+bool Solver::Solve(Board& board)
+{
+	while (board.GetState() == BoardState::PLAYING && FindForcedCells(board))
+	{
+		for (std::size_t index : mine_cells_)
+		{
+			board.ToggleFlag(index);
+		}
+
+		for (std::size_t index : safe_cells_)
+		{
+			board.Reveal(index);
+		}
+	}
+
+	return board.GetState() == BoardState::WON;
+}
+
+void Solver::Prepare(const Board& board)
+{
+	if (forced_safe_plane_.GetSize() != board.GetSize())
+	{
+		forced_safe_plane_.Reset(board.GetSize());
+		forced_mine_plane_.Reset(board.GetSize());
+	}
+	else
+	{
+		for (std::size_t index : safe_cells_)
+		{
+			forced_safe_plane_.Unset(index);
+		}
+
+		for (std::size_t index : mine_cells_)
+		{
+			forced_mine_plane_.Unset(index);
+		}
+	}
+
+	safe_cells_.clear();
+	mine_cells_.clear();
+}
+
+/* Brings the constraints up to date with the board. On a new layout every uncovered cell is visited by walking 
+ * the set bits of the uncovered plane, otherwise only the cells around bits that changed since the last call. */
+void Solver::UpdateConstraints(const Board& board)
+{
+	const BitPlane& uncovered_plane = board.GetUncoveredPlane();
+	const BitPlane& flag_plane = board.GetFlagPlane();
+	const std::uint64_t* uncovered_words = uncovered_plane.GetWords();
+	const std::uint64_t* flag_words = flag_plane.GetWords();
+
+	if (board.GetLayoutId() != layout_id_ || known_uncovered_plane_.GetSize() != board.GetSize())
+	{
+		layout_id_ = board.GetLayoutId();
+		constraints_.clear();
+		free_constraints_.clear();
+		single_point_constraints_.clear();
+		constraint_ids_.assign(board.GetSize(), no_constraint);
+		known_uncovered_plane_ = uncovered_plane;
+		known_flag_plane_ = flag_plane;
+
+		for (std::size_t word_index = 0; word_index < uncovered_plane.GetWordCount(); ++word_index)
+		{
+			std::uint64_t word = uncovered_words[word_index];
+
+			while (word != 0)
+			{
+				UpdateConstraint(board, word_index * 64 + __builtin_ctzll(word));
+				word &= word - 1;
+			}
+		}
+
+		return;
+	}
+
+	std::uint64_t* known_uncovered_words = known_uncovered_plane_.GetWords();
+	std::uint64_t* known_flag_words = known_flag_plane_.GetWords();
+
+	for (std::size_t word_index = 0; word_index < uncovered_plane.GetWordCount(); ++word_index)
+	{
+		std::uint64_t changed = (uncovered_words[word_index] ^ known_uncovered_words[word_index]) | (flag_words[word_index] ^ known_flag_words[word_index]);
+
+		if (changed == 0)
+		{
+			continue;
+		}
+
+		known_uncovered_words[word_index] = uncovered_words[word_index];
+		known_flag_words[word_index] = flag_words[word_index];
+
+		while (changed != 0)
+		{
+			UpdateConstraintsAround(board, word_index * 64 + __builtin_ctzll(changed));
+			changed &= changed - 1;
+		}
+	}
+}
+
+/* Rebuilds the constraint of an uncovered number from its neighbours, or drops it once it has no unknown 
+ * neighbours left. */
+void Solver::UpdateConstraint(const Board& board, std::size_t index)
+{
+	std::uint32_t& constraint_id = constraint_ids_[index];
+
+	if (constraint_id != no_constraint)
+	{
+		constraints_[constraint_id].unknown_mask_ = 0;
+		free_constraints_.push_back(constraint_id);
+		constraint_id = no_constraint;
+	}
+
+	const int mines_in_vicinity = board.GetMinesInVicinity(index);
+
+	if (!board.IsUncovered(index) || mines_in_vicinity == 0)
+	{
+		return;
+	}
+
+	const int width = board.GetWidth();
+	const int height = board.GetHeight();
+	const int x = static_cast<int>(index % width);
+	const int y = static_cast<int>(index / width);
+
+	Constraint constraint = { x, y, 0, mines_in_vicinity, false };
+
+	for (int dy = -1; dy <= 1; ++dy)
+	{
+		for (int dx = -1; dx <= 1; ++dx)
+		{
+			const int nx = x + dx;
+			const int ny = y + dy;
+
+			if ((dx == 0 && dy == 0) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+			{
+				continue;
+			}
+
+			const std::size_t neighbour_index = board.GetIndex(nx, ny);
+
+			if (board.IsFlagged(neighbour_index))
+			{
+				--constraint.mines_left_;
+			}
+			else if (!board.IsUncovered(neighbour_index))
+			{
+				constraint.unknown_mask_ |= std::uint64_t{ 1 } << GetWindowBit(dx, dy);
+			}
+		}
+	}
+
+	if (constraint.unknown_mask_ == 0)
+	{
+		return;
+	}
+
+	if (free_constraints_.empty())
+	{
+		constraint_id = static_cast<std::uint32_t>(constraints_.size());
+		constraints_.push_back(constraint);
+	}
+	else
+	{
+		constraint_id = free_constraints_.back();
+		free_constraints_.pop_back();
+		constraint.listed_ = constraints_[constraint_id].listed_;
+		constraints_[constraint_id] = constraint;
+	}
+
+	Constraint& stored_constraint = constraints_[constraint_id];
+
+	if (!stored_constraint.listed_ && IsSinglePointDecided(stored_constraint))
+	{
+		stored_constraint.listed_ = true;
+		single_point_constraints_.push_back(constraint_id);
+	}
+}
+
+/* A changed cell affects its own constraint and those of its eight neighbours. */
+void Solver::UpdateConstraintsAround(const Board& board, std::size_t index)
+{
+	const int width = board.GetWidth();
+	const int height = board.GetHeight();
+	const int x = static_cast<int>(index % width);
+	const int y = static_cast<int>(index / width);
+
+	for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height - 1); ++ny)
+	{
+		for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width - 1); ++nx)
+		{
+			UpdateConstraint(board, board.GetIndex(nx, ny));
+		}
+	}
+}
+
+bool Solver::IsSinglePointDecided(const Constraint& constraint)
+{
+	return constraint.unknown_mask_ != 0 && (constraint.mines_left_ == 0 || constraint.mines_left_ == CountBits(constraint.unknown_mask_));
+}
+
+/* Only the listed slots can be decided. Slots that stopped being decided since are dropped from the list. */
+void Solver::ApplySinglePointRule(const Board& board)
+{
+	std::size_t kept = 0;
+
+	for (std::uint32_t constraint_id : single_point_constraints_)
+	{
+		Constraint& constraint = constraints_[constraint_id];
+
+		if (!IsSinglePointDecided(constraint))
+		{
+			constraint.listed_ = false;
+			continue;
+		}
+
+		MarkWindow(board, constraint, constraint.unknown_mask_, constraint.mines_left_ != 0);
+		single_point_constraints_[kept++] = constraint_id;
+	}
+
+	single_point_constraints_.resize(kept);
+}
+
+/* Pair rule for constraints A and B up to two cells apart: if B needs exactly |B \ A| more mines than A, 
+ * every cell of B \ A is a mine and every cell of A \ B is safe. When A is a subset of B this is the subset rule. */
+void Solver::ApplyPairRules(const Board& board)
+{
+	const int width = board.GetWidth();
+	const int height = board.GetHeight();
+
+	for (std::size_t a = 0; a < constraints_.size(); ++a)
+	{
+		const Constraint& constraint_a = constraints_[a];
+
+		if (constraint_a.unknown_mask_ == 0)
+		{
+			continue;
+		}
+
+		for (int dy = -2; dy <= 2; ++dy)
+		{
+			for (int dx = -2; dx <= 2; ++dx)
+			{
+				const int nx = constraint_a.x_ + dx;
+				const int ny = constraint_a.y_ + dy;
+
+				if ((dx == 0 && dy == 0) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+				{
+					continue;
+				}
+
+				const std::uint32_t b = constraint_ids_[board.GetIndex(nx, ny)];
+
+				if (b == no_constraint || b < a)
+				{
+					continue;
+				}
+
+				const Constraint& constraint_b = constraints_[b];
+
+				const std::uint64_t mask_a = constraint_a.unknown_mask_;
+				const std::uint64_t mask_b = ShiftWindow(constraint_b.unknown_mask_, dx, dy);
+
+				if ((mask_a & mask_b) == 0)
+				{
+					continue;
+				}
+
+				const std::uint64_t only_a = mask_a & ~mask_b;
+				const std::uint64_t only_b = mask_b & ~mask_a;
+				const int difference = constraint_b.mines_left_ - constraint_a.mines_left_;
+
+				if (difference == CountBits(only_b))
+				{
+					MarkWindow(board, constraint_a, only_b, true);
+					MarkWindow(board, constraint_a, only_a, false);
+				}
+				else if (-difference == CountBits(only_a))
+				{
+					MarkWindow(board, constraint_a, only_a, true);
+					MarkWindow(board, constraint_a, only_b, false);
+				}
+			}
+		}
+	}
+}
+
+/* With no mines left every unknown cell is safe, with as many unknown cells as mines left they are all mines. */
+void Solver::ApplyMineCounterRule(const Board& board)
+{
+	const int mines_left = board.GetMinesLeft();
+	const int unknown = board.GetCoveredSafeCells() + board.GetMines() - board.GetFlagsPlaced();
+
+	if (mines_left != 0 && mines_left != unknown)
+	{
+		return;
+	}
+
+	for (std::size_t i = 0; i < board.GetSize(); ++i)
+	{
+		if (!board.IsFlagged(i) && !board.IsUncovered(i))
+		{
+			mines_left == 0 ? MarkSafe(i) : MarkMine(i);
+		}
+	}
+}
+
+void Solver::MarkWindow(const Board& board, const Constraint& constraint, std::uint64_t mask, bool mines)
+{
+	while (mask != 0)
+	{
+		const int bit = __builtin_ctzll(mask);
+		mask &= mask - 1;
+
+		const std::size_t index = board.GetIndex(constraint.x_ + bit % window_size - window_center, constraint.y_ + bit / window_size - window_center);
+		mines ? MarkMine(index) : MarkSafe(index);
+	}
+}
+
+void Solver::MarkSafe(std::size_t index)
+{
+	if (!forced_safe_plane_.Get(index))
+	{
+		forced_safe_plane_.Set(index);
+		safe_cells_.push_back(index);
+	}
+}
+
+void Solver::MarkMine(std::size_t index)
+{
+	if (!forced_mine_plane_.Get(index))
+	{
+		forced_mine_plane_.Set(index);
+		mine_cells_.push_back(index);
+	}
+}
@@ -0,0 +1,197 @@
+#include "SpriteAtlas.hpp"
+#include "Profiler.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <algorithm>
+#include <string>
+
+SpriteAtlas::SpriteAtlas() : 
+	texture_(std::make_unique<Texture>()), 
+	covered_rect_({ 0, 0, 0, 0 }), 
+	mine_rect_({ 0, 0, 0, 0 }), 
+	flag_rect_({ 0, 0, 0, 0 }), 
+	white_rect_({ 0, 0, 0, 0 }), 
+	digit_rects_()
+{
+}
+
+SpriteAtlas::~SpriteAtlas()
+{
+}
+
+bool SpriteAtlas::Load(SDL_Renderer* renderer, TTF_Font* font, const char* sprites_path)
+{
+	PROFILE_ZONE("SpriteAtlas::Load");
+
+	constexpr int sprite_size = 32;
+	constexpr int white_size = 4;
+
+	const SDL_Color digit_colors[8] = { { 0x00, 0x00, 0xFF, 0xFF }, { 0x00, 0xFF, 0x00, 0xFF }, { 0xFF, 0x00, 0x00, 0xFF },
+										{ 0x00, 0x61, 0x76, 0xFF }, { 0xA1, 0x61, 0x76, 0xFF }, { 0xC4, 0xBA, 0x07, 0xFF },
+										{ 0xA7, 0x14, 0x9F, 0xFF }, { 0x00, 0x00, 0x00, 0xFF } };
+
+	SDL_Surface* sprites_surface = IMG_Load(sprites_path);
+
+	if (sprites_surface == nullptr)
+	{
+		printf("Unable to load image %s! SDL_image Error: %s\n", sprites_path, IMG_GetError());
+		return false;
+	}
+
+	/* Magenta is transparent in the sprite sheet. */
+	SDL_SetColorKey(sprites_surface, SDL_TRUE, SDL_MapRGB(sprites_surface->format, 0xFF, 0x00, 0xFF));
+	SDL_SetSurfaceBlendMode(sprites_surface, SDL_BLENDMODE_NONE);
+
+	std::array<SDL_Surface*, 8> digit_surfaces = {};
+	int digits_width = 0;
+	int digits_height = 0;
+	bool loaded = true;
+
+	for (int i = 0; i < 8 && loaded; ++i)
+	{
+		digit_surfaces[i] = TTF_RenderText_Blended(font, std::to_string(i + 1).c_str(), digit_colors[i]);
+
+		if (digit_surfaces[i] == nullptr)
+		{
+			printf("Unable to render text surface! SDL_ttf Error: %s\n", TTF_GetError());
+			loaded = false;
+			break;
+		}
+
+		/* Copied as is, blending onto the transparent atlas would darken the glyph edges. */
+		SDL_SetSurfaceBlendMode(digit_surfaces[i], SDL_BLENDMODE_NONE);
+
+		digits_width += digit_surfaces[i]->w;
+		digits_height = std::max(digits_height, digit_surfaces[i]->h);
+	}
+
+	SDL_Surface* atlas_surface = nullptr;
+
+	if (loaded)
+	{
+		const int atlas_width = std::max(sprites_surface->w, digits_width + white_size);
+		const int atlas_height = sprites_surface->h + std::max(digits_height, white_size);
+
+		atlas_surface = SDL_CreateRGBSurfaceWithFormat(0, atlas_width, atlas_height, 32, SDL_PIXELFORMAT_RGBA32);
+
+		if (atlas_surface == nullptr)
+		{
+			printf("Unable to create the sprite atlas surface! SDL Error: %s\n", SDL_GetError());
+			loaded = false;
+		}
+	}
+
+	if (loaded)
+	{
+		SDL_FillRect(atlas_surface, nullptr, SDL_MapRGBA(atlas_surface->format, 0x00, 0x00, 0x00, 0x00));
+
+		SDL_Rect sprites_destination = { 0, 0, sprites_surface->w, sprites_surface->h };
+		SDL_BlitSurface(sprites_surface, nullptr, atlas_surface, &sprites_destination);
+
+		covered_rect_ = { 0, 0, sprite_size, sprite_size };
+		mine_rect_ = { sprite_size, 0, sprite_size, sprite_size };
+		flag_rect_ = { sprite_size * 2, 0, sprite_size, sprite_size };
+
+		int x = 0;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			digit_rects_[i] = { x, sprites_surface->h, digit_surfaces[i]->w, digit_surfaces[i]->h };
+			SDL_Rect digit_destination = digit_rects_[i];
+			SDL_BlitSurface(digit_surfaces[i], nullptr, atlas_surface, &digit_destination);
+
+			x += digit_surfaces[i]->w;
+		}
+
+		white_rect_ = { x, sprites_surface->h, white_size, white_size };
+		SDL_FillRect(atlas_surface, &white_rect_, SDL_MapRGBA(atlas_surface->format, 0xFF, 0xFF, 0xFF, 0xFF));
+
+		loaded = texture_->LoadFromSurface(renderer, atlas_surface);
+
+		if (loaded)
+		{
+			SDL_SetTextureBlendMode(texture_->texture_, SDL_BLENDMODE_BLEND);
+		}
+	}
+
+	for (SDL_Surface* digit_surface : digit_surfaces)
+	{
+		if (digit_surface != nullptr)
+		{
+			SDL_FreeSurface(digit_surface);
+		}
+	}
+
+	if (atlas_surface != nullptr)
+	{
+		SDL_FreeSurface(atlas_surface);
+	}
+
+	SDL_FreeSurface(sprites_surface);
+
+	return loaded;
+}
+
+Texture* SpriteAtlas::GetTexture() const
+{
+	return texture_.get();
+}
+
+const SDL_Rect& SpriteAtlas::GetCoveredRect() const
+{
+	return covered_rect_;
+}
+
+const SDL_Rect& SpriteAtlas::GetMineRect() const
+{
+	return mine_rect_;
+}
+
+const SDL_Rect& SpriteAtlas::GetFlagRect() const
+{
+	return flag_rect_;
+}
+
+const SDL_Rect& SpriteAtlas::GetDigitRect(int digit) const
+{
+	return digit_rects_[digit - 1];
+}
+
+void SpriteAtlas::WriteQuad(SDL_Vertex* vertices, const SDL_Rect& destination, const SDL_Rect& source, const SDL_Color& color) const
+{
+	const float inverse_width = texture_->width_ > 0 ? 1.0f / texture_->width_ : 0.0f;
+	const float inverse_height = texture_->height_ > 0 ? 1.0f / texture_->height_ : 0.0f;
+
+	const float x0 = static_cast<float>(destination.x);
+	const float y0 = static_cast<float>(destination.y);
+	const float x1 = static_cast<float>(destination.x + destination.w);
+	const float y1 = static_cast<float>(destination.y + destination.h);
+
+	const float u0 = source.x * inverse_width;
+	const float v0 = source.y * inverse_height;
+	const float u1 = (source.x + source.w) * inverse_width;
+	const float v1 = (source.y + source.h) * inverse_height;
+
+	vertices[0] = { { x0, y0 }, color, { u0, v0 } };
+	vertices[1] = { { x1, y0 }, color, { u1, v0 } };
+	vertices[2] = { { x1, y1 }, color, { u1, v1 } };
+	vertices[3] = { { x0, y1 }, color, { u0, v1 } };
+}
+
+void SpriteAtlas::WriteSolidQuad(SDL_Vertex* vertices, const SDL_Rect& destination, const SDL_Color& color) const
+{
+	/* Every corner samples the middle of the white block, so filtering never reaches transparent texels. */
+	const SDL_Rect white_center = { white_rect_.x + white_rect_.w / 2, white_rect_.y + white_rect_.h / 2, 0, 0 };
+
+	WriteQuad(vertices, destination, white_center, color);
+}
+
+void SpriteAtlas::WriteEmptyQuad(SDL_Vertex* vertices) const
+{
+	const SDL_Vertex empty_vertex = { { 0.0f, 0.0f }, { 0x00, 0x00, 0x00, 0x00 }, { 0.0f, 0.0f } };
+
+	std::fill(vertices, vertices + 4, empty_vertex);
+}
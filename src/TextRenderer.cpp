@@ -0,0 +1,183 @@
+#include "TextRenderer.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <algorithm>
+
+TextRenderer::TextRenderer() : 
+	texture_(std::make_unique<Texture>()), 
+	glyphs_(), 
+	line_height_(0)
+{
+}
+
+TextRenderer::~TextRenderer()
+{
+}
+
+bool TextRenderer::Load(SDL_Renderer* renderer, TTF_Font* font)
+{
+	PROFILE_ZONE("TextRenderer::Load");
+
+	constexpr int atlas_width = 512;
+	const SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+	std::array<SDL_Surface*, last_glyph - first_glyph + 1> glyph_surfaces = {};
+	bool loaded = true;
+
+	int x = 0;
+	int y = 0;
+	int row_height = 0;
+
+	for (int i = 0; i < static_cast<int>(glyphs_.size()) && loaded; ++i)
+	{
+		const Uint16 character = static_cast<Uint16>(first_glyph + i);
+
+		glyph_surfaces[i] = TTF_RenderGlyph_Blended(font, character, white);
+
+		int advance = 0;
+
+		if (glyph_surfaces[i] == nullptr || TTF_GlyphMetrics(font, character, nullptr, nullptr, nullptr, nullptr, &advance) != 0)
+		{
+			printf("Unable to render glyph %d! SDL_ttf Error: %s\n", character, TTF_GetError());
+			loaded = false;
+			break;
+		}
+
+		/* Copied as is, blending onto the transparent atlas would darken the glyph edges. */
+		SDL_SetSurfaceBlendMode(glyph_surfaces[i], SDL_BLENDMODE_NONE);
+
+		if (x + glyph_surfaces[i]->w > atlas_width)
+		{
+			x = 0;
+			y += row_height;
+			row_height = 0;
+		}
+
+		glyphs_[i] = { { x, y, glyph_surfaces[i]->w, glyph_surfaces[i]->h }, advance };
+
+		x += glyph_surfaces[i]->w;
+		row_height = std::max(row_height, glyph_surfaces[i]->h);
+	}
+
+	SDL_Surface* atlas_surface = nullptr;
+
+	if (loaded)
+	{
+		atlas_surface = SDL_CreateRGBSurfaceWithFormat(0, atlas_width, y + row_height, 32, SDL_PIXELFORMAT_RGBA32);
+
+		if (atlas_surface == nullptr)
+		{
+			printf("Unable to create the glyph atlas surface! SDL Error: %s\n", SDL_GetError());
+			loaded = false;
+		}
+	}
+
+	if (loaded)
+	{
+		SDL_FillRect(atlas_surface, nullptr, SDL_MapRGBA(atlas_surface->format, 0xFF, 0xFF, 0xFF, 0x00));
+
+		for (std::size_t i = 0; i < glyphs_.size(); ++i)
+		{
+			SDL_Rect destination = glyphs_[i].rect_;
+			SDL_BlitSurface(glyph_surfaces[i], nullptr, atlas_surface, &destination);
+		}
+
+		loaded = texture_->LoadFromSurface(renderer, atlas_surface);
+
+		if (loaded)
+		{
+			SDL_SetTextureBlendMode(texture_->texture_, SDL_BLENDMODE_BLEND);
+		}
+
+		line_height_ = TTF_FontHeight(font);
+	}
+
+	for (SDL_Surface* glyph_surface : glyph_surfaces)
+	{
+		if (glyph_surface != nullptr)
+		{
+			SDL_FreeSurface(glyph_surface);
+		}
+	}
+
+	if (atlas_surface != nullptr)
+	{
+		SDL_FreeSurface(atlas_surface);
+	}
+
+	return loaded;
+}
+
+const TextRenderer::Glyph& TextRenderer::GetGlyph(char character) const
+{
+	if (character < first_glyph || character > last_glyph)
+	{
+		character = '?';
+	}
+
+	return glyphs_[character - first_glyph];
+}
+
+void TextRenderer::MeasureText(const char* text, int* width, int* height) const
+{
+	int text_width = 0;
+
+	for (const char* character = text; *character != '\0'; ++character)
+	{
+		text_width += GetGlyph(*character).advance_;
+	}
+
+	*width = text_width;
+	*height = line_height_;
+}
+
+void TextRenderer::DrawText(const char* text, int x, int y, const SDL_Color& color)
+{
+	const float inverse_width = texture_->width_ > 0 ? 1.0f / texture_->width_ : 0.0f;
+	const float inverse_height = texture_->height_ > 0 ? 1.0f / texture_->height_ : 0.0f;
+
+	for (const char* character = text; *character != '\0'; ++character)
+	{
+		const Glyph& glyph = GetGlyph(*character);
+		const SDL_Rect& source = glyph.rect_;
+
+		const float x0 = static_cast<float>(x);
+		const float y0 = static_cast<float>(y);
+		const float x1 = static_cast<float>(x + source.w);
+		const float y1 = static_cast<float>(y + source.h);
+
+		const float u0 = source.x * inverse_width;
+		const float v0 = source.y * inverse_height;
+		const float u1 = (source.x + source.w) * inverse_width;
+		const float v1 = (source.y + source.h) * inverse_height;
+
+		const int first_vertex = static_cast<int>(vertices_.size());
+
+		vertices_.push_back({ { x0, y0 }, color, { u0, v0 } });
+		vertices_.push_back({ { x1, y0 }, color, { u1, v0 } });
+		vertices_.push_back({ { x1, y1 }, color, { u1, v1 } });
+		vertices_.push_back({ { x0, y1 }, color, { u0, v1 } });
+
+		indices_.insert(indices_.end(), { first_vertex, first_vertex + 1, first_vertex + 2, first_vertex, first_vertex + 2, first_vertex + 3 });
+
+		x += glyph.advance_;
+	}
+}
+
+void TextRenderer::Flush(SDL_Renderer* renderer)
+{
+	if (indices_.empty())
+	{
+		return;
+	}
+
+	SDL_RenderGeometry(renderer, texture_->texture_, vertices_.data(), static_cast<int>(vertices_.size()), indices_.data(), static_cast<int>(indices_.size()));
+	render_stats::CountDrawCall();
+
+	vertices_.clear();
+	indices_.clear();
+}
@@ -1,4 +1,6 @@
 #include "Texture.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
@@ -26,6 +28,8 @@ void Texture::FreeTexture()
 
 bool Texture::LoadFromPath(SDL_Renderer* renderer, const char* path)
 {
+	PROFILE_ZONE("Texture::LoadFromPath");
+
 	FreeTexture();
 
 	SDL_Texture* tmp_texture = nullptr;
@@ -47,6 +51,7 @@ bool Texture::LoadFromPath(SDL_Renderer* renderer, const char* path)
 	}
 	else
 	{
+		render_stats::CountTextureUpload();
 		width_ = loaded_surface->w;
 		height_ = loaded_surface->h;
 	}
@@ -57,8 +62,30 @@ bool Texture::LoadFromPath(SDL_Renderer* renderer, const char* path)
 	return texture_ != nullptr;
 }
 
+bool Texture::LoadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface)
+{
+	PROFILE_ZONE("Texture::LoadFromSurface");
+
+	FreeTexture();
+
+	texture_ = SDL_CreateTextureFromSurface(renderer, surface);
+
+	if (texture_ == nullptr)
+	{
+		printf("Unable to create texture from surface! SDL Error: %s\n", SDL_GetError());
+		return false;
+	}
+
+	render_stats::CountTextureUpload();
+	width_ = surface->w;
+	height_ = surface->h;
+	return true;
+}
+
 bool Texture::LoadFromText(SDL_Renderer* renderer, TTF_Font* font, const char* text, const SDL_Color& text_color, int text_length)
 {
+	PROFILE_ZONE("Texture::LoadFromText");
+
 	FreeTexture();
 
 	SDL_Surface* text_surface = text_length == -1 ? TTF_RenderText_Blended(font, text, text_color) : TTF_RenderText_Blended_Wrapped(font, text, text_color, text_length);
@@ -78,6 +105,7 @@ bool Texture::LoadFromText(SDL_Renderer* renderer, TTF_Font* font, const char* t
 		return false;
 	}
 
+	render_stats::CountTextureUpload();
 	width_ = text_surface->w;
 	height_ = text_surface->h;
 	SDL_FreeSurface(text_surface);
@@ -95,4 +123,5 @@ void Texture::Render(SDL_Renderer* renderer, int x, int y, float scale, SDL_Rect
 	}
 
 	SDL_RenderCopy(renderer, texture_, clip, &render_rect);
+	render_stats::CountDrawCall();
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace
+{
+	/* Pool and worker index of the calling thread. current_pool is null on threads that are not pool workers. */
+	thread_local const void* current_pool = nullptr;
+	thread_local std::size_t current_worker_index = 0;
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t thread_count) : 
+	queued_tasks_(0), 
+	next_queue_(0), 
+	stopping_(false)
+{
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (std::size_t i = 0; i < thread_count; ++i)
+	{
+		queues_.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	for (std::size_t i = 0; i < thread_count; ++i)
+	{
+		threads_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex_);
+		stopping_ = true;
+	}
+
+	wake_condition_.notify_all();
+
+	for (std::thread& thread : threads_)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::Submit(TaskGroup& task_group, std::function<void()> task)
+{
+	task_group.pending_.fetch_add(1, std::memory_order_relaxed);
+
+	std::function<void()> group_task = [this, &task_group, task = std::move(task)]
+	{
+		task();
+
+		if (task_group.pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex_);
+			done_condition_.notify_all();
+		}
+	};
+
+	const std::size_t queue_index = current_pool == this ? current_worker_index : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+	/* Counted before it is queued, so the counter never drops below the number of queued tasks. */
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex_);
+		queued_tasks_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queues_[queue_index]->mutex_);
+		queues_[queue_index]->tasks_.push_back(std::move(group_task));
+	}
+
+	wake_condition_.notify_one();
+	done_condition_.notify_all();
+}
+
+void ThreadPool::Wait(TaskGroup& task_group)
+{
+	const std::size_t first_queue = current_pool == this ? current_worker_index : 0;
+
+	while (task_group.pending_.load(std::memory_order_acquire) != 0)
+	{
+		if (TryRunTask(first_queue))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex_);
+		done_condition_.wait(lock, [this, &task_group]
+		{
+			return task_group.pending_.load(std::memory_order_acquire) == 0 || queued_tasks_.load(std::memory_order_relaxed) != 0;
+		});
+	}
+}
+
+std::size_t ThreadPool::GetThreadCount() const
+{
+	return threads_.size();
+}
+
+void ThreadPool::WorkerLoop(std::size_t worker_index)
+{
+	current_pool = this;
+	current_worker_index = worker_index;
+
+	while (true)
+	{
+		if (TryRunTask(worker_index))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex_);
+		wake_condition_.wait(lock, [this]
+		{
+			return stopping_ || queued_tasks_.load(std::memory_order_relaxed) != 0;
+		});
+
+		if (stopping_ && queued_tasks_.load(std::memory_order_relaxed) == 0)
+		{
+			return;
+		}
+	}
+}
+
+bool ThreadPool::TryRunTask(std::size_t first_queue)
+{
+	std::function<void()> task;
+
+	for (std::size_t i = 0; i < queues_.size(); ++i)
+	{
+		const std::size_t queue_index = (first_queue + i) % queues_.size();
+
+		if (TryPopTask(queue_index, i != 0, &task))
+		{
+			queued_tasks_.fetch_sub(1, std::memory_order_relaxed);
+			task();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ThreadPool::TryPopTask(std::size_t queue_index, bool steal, std::function<void()>* task)
+{
+	WorkerQueue& queue = *queues_[queue_index];
+	std::lock_guard<std::mutex> lock(queue.mutex_);
+
+	if (queue.tasks_.empty())
+	{
+		return false;
+	}
+
+	if (steal)
+	{
+		*task = std::move(queue.tasks_.front());
+		queue.tasks_.pop_front();
+	}
+	else
+	{
+		*task = std::move(queue.tasks_.back());
+		queue.tasks_.pop_back();
+	}
+
+	return true;
+}
@@ -1,14 +1,85 @@
+#include "Constants.hpp"
 #include "Game.hpp"
+#include "Profiler.hpp"
 
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 
 int main(int argc, char* argv[])
 {
-	(void) argc;
-	(void) argv;
+	/* --benchmark-frames N plays N scripted frames per board size offscreen and prints frame statistics. 
+	 * --vsync presents in step with the display, --busy-loop renders continuously instead of waiting for input.
+	 * Games are appended to replay.bin unless --no-record is given, --replay FILE plays a log back in real time. 
+	 * --resume continues the game in save.bin, which is written every few seconds and on exit. */
+	int benchmark_frames = 0;
+	bool vsync = false;
+	bool busy_loop = false;
+	bool record = true;
+	bool resume = false;
+	const char* replay_path = nullptr;
 
-	const std::unique_ptr<Game> game = std::make_unique<Game>();
-	game->Run();
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--benchmark-frames") == 0 && i + 1 < argc)
+		{
+			benchmark_frames = std::atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+		{
+			replay_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "--vsync") == 0)
+		{
+			vsync = true;
+		}
+		else if (strcmp(argv[i], "--busy-loop") == 0)
+		{
+			busy_loop = true;
+		}
+		else if (strcmp(argv[i], "--no-record") == 0)
+		{
+			record = false;
+		}
+		else if (strcmp(argv[i], "--resume") == 0)
+		{
+			resume = true;
+		}
+	}
+
+	const std::unique_ptr<Game> game = std::make_unique<Game>(benchmark_frames > 0, vsync);
+
+	if (benchmark_frames > 0)
+	{
+		game->RunFrameBenchmark(benchmark_frames);
+	}
+	else
+	{
+		if (replay_path != nullptr)
+		{
+			game->LoadReplay(replay_path);
+		}
+		else
+		{
+			if (record)
+			{
+				game->StartRecording("replay.bin");
+			}
+
+			if (resume)
+			{
+				game->LoadGame(constants::save_path);
+			}
+
+			game->EnableAutosave(constants::save_path);
+		}
+
+		game->Run(!busy_loop);
+	}
+
+#ifdef MINESWEEPER_PROFILE
+	profiler::WriteTrace("trace.json");
+#endif
 
 	return 0;
 }
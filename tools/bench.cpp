@@ -0,0 +1,932 @@
+#include "Board.hpp"
+#include "BitPlane.hpp"
+#include "MinePlacement.hpp"
+#include "NeighbourCount.hpp"
+#include "Random.hpp"
+#include "Snapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::atomic<std::size_t> allocation_count(0);
+}
+
+/* Every allocation of the process goes through these, so each benchmark can report allocations per operation. 
+ * The deletes are kept out of line, otherwise GCC sees free() on a pointer from new and warns. */
+void* operator new(std::size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+	void* pointer = std::malloc(size == 0 ? 1 : size);
+
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return pointer;
+}
+
+__attribute__((noinline)) void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+namespace
+{
+	/* Accumulates time and allocations over the timed sections of one benchmark. Setup between Stop and Start
+	 * is not counted. The first section is a warm-up and counts for neither, it pays for one-off growth like the
+	 * first Reset. Allocations are only counted over the next allocation_samples sections, so they do not depend 
+	 * on how many sections the machine manages in the time budget. */
+	class Measurement
+	{
+	private:
+		static constexpr std::size_t allocation_samples = 3;
+
+		std::chrono::steady_clock::time_point start_time_;
+		std::size_t start_allocations_;
+		std::size_t samples_;
+		double nanoseconds_;
+		std::size_t operations_;
+		std::size_t allocations_;
+		std::size_t allocation_operations_;
+
+	public:
+		Measurement() :
+			start_time_(),
+			start_allocations_(0),
+			samples_(0),
+			nanoseconds_(0.0),
+			operations_(0),
+			allocations_(0),
+			allocation_operations_(0)
+		{
+		}
+
+		void Start()
+		{
+			start_allocations_ = allocation_count.load(std::memory_order_relaxed);
+			start_time_ = std::chrono::steady_clock::now();
+		}
+
+		void Stop(std::size_t operations)
+		{
+			const auto end_time = std::chrono::steady_clock::now();
+			const std::size_t allocations = allocation_count.load(std::memory_order_relaxed) - start_allocations_;
+
+			if (samples_ > 0)
+			{
+				nanoseconds_ += std::chrono::duration<double, std::nano>(end_time - start_time_).count();
+				operations_ += operations;
+			}
+
+			if (samples_ > 0 && samples_ <= allocation_samples)
+			{
+				allocations_ += allocations;
+				allocation_operations_ += operations;
+			}
+
+			++samples_;
+		}
+
+		/* Benchmarks repeat until this is false, so fast operations get enough samples and slow ones finish. 
+		 * The warm-up and the sections that count allocations always run. */
+		bool NeedsMoreSamples(std::chrono::steady_clock::time_point benchmark_start) const
+		{
+			constexpr double min_nanoseconds = 2e8;
+			constexpr double max_wall_seconds = 2.0;
+
+			return samples_ <= allocation_samples || (nanoseconds_ < min_nanoseconds
+				&& std::chrono::duration<double>(std::chrono::steady_clock::now() - benchmark_start).count() < max_wall_seconds);
+		}
+
+		double GetNanosecondsPerOperation() const
+		{
+			return operations_ > 0 ? nanoseconds_ / operations_ : 0.0;
+		}
+
+		double GetAllocationsPerOperation() const
+		{
+			return allocation_operations_ > 0 ? static_cast<double>(allocations_) / allocation_operations_ : 0.0;
+		}
+
+		std::size_t GetOperations() const
+		{
+			return operations_;
+		}
+	};
+
+	struct BenchmarkResult
+	{
+		std::string name_;
+		double ns_per_op_;
+		double allocations_per_op_;
+		std::size_t operations_;
+	};
+
+	struct BenchmarkSize
+	{
+		const char* name_;
+		int width_;
+		int height_;
+		int mines_;
+	};
+
+	std::vector<BenchmarkResult> results;
+	bool checks_failed = false;
+
+	/* Benchmarks run when their full recorded name contains this. */
+	std::string filter;
+
+	bool IsSelected(const std::string& name)
+	{
+		return name.find(filter) != std::string::npos;
+	}
+
+	void Record(const std::string& name, const Measurement& measurement)
+	{
+		results.push_back({ name, measurement.GetNanosecondsPerOperation(), measurement.GetAllocationsPerOperation(), measurement.GetOperations() });
+	}
+
+	void ReportFailure(const std::string& name, const char* message)
+	{
+		fprintf(stderr, "%s: %s\n", name.c_str(), message);
+		checks_failed = true;
+	}
+
+	std::size_t GetCenterIndex(const Board& board)
+	{
+		return board.GetIndex(board.GetWidth() / 2, board.GetHeight() / 2);
+	}
+
+	/* What the game does on a new board and its first click: reset, then place mines around the click. */
+	void BenchmarkGenerateBoard(const BenchmarkSize& size)
+	{
+		const std::string name = std::string("generate_board/") + size.name_;
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		const auto benchmark_start = std::chrono::steady_clock::now();
+
+		Board board;
+		Measurement measurement;
+		std::uint64_t seed = 0;
+
+		while (measurement.NeedsMoreSamples(benchmark_start))
+		{
+			measurement.Start();
+			board.Reset(size.width_, size.height_, size.mines_);
+			board.PlaceMines(seed++, GetCenterIndex(board));
+			measurement.Stop(1);
+		}
+
+		Record(name, measurement);
+	}
+
+	/* Places and removes a flag on every covered cell. */
+	void BenchmarkToggleFlag(const BenchmarkSize& size)
+	{
+		const std::string name = std::string("toggle_flag/") + size.name_;
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		const auto benchmark_start = std::chrono::steady_clock::now();
+
+		Board board(size.width_, size.height_, size.mines_);
+		board.PlaceMines(1);
+
+		Measurement measurement;
+
+		while (measurement.NeedsMoreSamples(benchmark_start))
+		{
+			measurement.Start();
+
+			for (std::size_t i = 0; i < board.GetSize(); ++i)
+			{
+				board.ToggleFlag(i);
+			}
+
+			for (std::size_t i = 0; i < board.GetSize(); ++i)
+			{
+				board.ToggleFlag(i);
+			}
+
+			measurement.Stop(board.GetSize() * 2);
+		}
+
+		if (board.GetFlagsPlaced() != 0)
+		{
+			ReportFailure(name, "flags left on the board");
+		}
+
+		Record(name, measurement);
+	}
+
+	/* Uncovers every numbered safe cell one by one. Numbered cells never cascade, so each call uncovers one cell. */
+	void BenchmarkRevealSingle(const BenchmarkSize& size)
+	{
+		const std::string name = std::string("reveal_single/") + size.name_;
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		const auto benchmark_start = std::chrono::steady_clock::now();
+
+		Board board;
+		Measurement measurement;
+		std::vector<std::size_t> numbered_cells;
+		std::uint64_t seed = 0;
+
+		while (measurement.NeedsMoreSamples(benchmark_start))
+		{
+			board.Reset(size.width_, size.height_, size.mines_);
+			board.PlaceMines(seed++);
+
+			numbered_cells.clear();
+
+			for (std::size_t i = 0; i < board.GetSize(); ++i)
+			{
+				if (!board.IsMine(i) && board.GetMinesInVicinity(i) != 0)
+				{
+					numbered_cells.push_back(i);
+				}
+			}
+
+			measurement.Start();
+
+			for (std::size_t index : numbered_cells)
+			{
+				board.Reveal(index);
+			}
+
+			measurement.Stop(numbered_cells.size());
+
+			if (board.GetState() == BoardState::LOST)
+			{
+				ReportFailure(name, "a numbered cell exploded");
+			}
+		}
+
+		Record(name, measurement);
+	}
+
+	/* First click of a game: the mines avoid the clicked cell and its neighbours, so it always cascades. */
+	void BenchmarkRevealCascade(const BenchmarkSize& size)
+	{
+		const std::string name = std::string("reveal_cascade/") + size.name_;
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		const auto benchmark_start = std::chrono::steady_clock::now();
+
+		Board board;
+		Measurement measurement;
+		std::uint64_t seed = 0;
+
+		while (measurement.NeedsMoreSamples(benchmark_start))
+		{
+			board.Reset(size.width_, size.height_, size.mines_);
+			board.PlaceMines(seed++, GetCenterIndex(board));
+
+			measurement.Start();
+			board.Reveal(GetCenterIndex(board));
+			measurement.Stop(1);
+
+			if (board.GetState() == BoardState::LOST)
+			{
+				ReportFailure(name, "the first click exploded");
+			}
+		}
+
+		Record(name, measurement);
+	}
+
+	/* Flags every mine, then chords every numbered cell. Early chords cascade, later ones find nothing left. */
+	void BenchmarkChord(const BenchmarkSize& size)
+	{
+		const std::string name = std::string("chord/") + size.name_;
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		const auto benchmark_start = std::chrono::steady_clock::now();
+
+		Board board;
+		Measurement measurement;
+		std::vector<std::size_t> numbered_cells;
+		std::uint64_t seed = 0;
+
+		while (measurement.NeedsMoreSamples(benchmark_start))
+		{
+			board.Reset(size.width_, size.height_, size.mines_);
+			board.PlaceMines(seed++);
+
+			numbered_cells.clear();
+
+			for (std::size_t i = 0; i < board.GetSize(); ++i)
+			{
+				if (board.IsMine(i))
+				{
+					board.ToggleFlag(i);
+				}
+				else if (board.GetMinesInVicinity(i) != 0)
+				{
+					numbered_cells.push_back(i);
+				}
+			}
+
+			for (std::size_t index : numbered_cells)
+			{
+				board.Reveal(index);
+			}
+
+			measurement.Start();
+
+			for (std::size_t index : numbered_cells)
+			{
+				board.Chord(index);
+			}
+
+			measurement.Stop(numbered_cells.size());
+
+			if (board.GetState() != BoardState::WON && board.GetCoveredSafeCells() != 0)
+			{
+				ReportFailure(name, "chording left safe cells covered");
+			}
+		}
+
+		Record(name, measurement);
+	}
+
+	void BenchmarkNeighbourIndices(const BenchmarkSize& size)
+	{
+		const std::string name = std::string("neighbour_indices/") + size.name_;
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		const auto benchmark_start = std::chrono::steady_clock::now();
+
+		Board board(size.width_, size.height_, size.mines_);
+
+		Measurement measurement;
+		std::size_t checksum = 0;
+
+		while (measurement.NeedsMoreSamples(benchmark_start))
+		{
+			measurement.Start();
+
+			for (std::size_t i = 0; i < board.GetSize(); ++i)
+			{
+				for (std::size_t neighbour_index : board.GetNeighboursIndices(i))
+				{
+					checksum += neighbour_index;
+				}
+			}
+
+			measurement.Stop(board.GetSize());
+		}
+
+		/* Keeps the loop from being optimized away. */
+		if (checksum == 1)
+		{
+			ReportFailure(name, "impossible checksum");
+		}
+
+		Record(name, measurement);
+	}
+
+	/* What the game does on every mouse move over the board: press the cell and its neighbours, then clear them
+	 * but keep the cell under the mouse. */
+	void BenchmarkResetPressed(const BenchmarkSize& size)
+	{
+		const std::string name = std::string("reset_pressed/") + size.name_;
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		const auto benchmark_start = std::chrono::steady_clock::now();
+
+		Board board(size.width_, size.height_, size.mines_);
+		const std::size_t center_index = GetCenterIndex(board);
+
+		Measurement measurement;
+
+		while (measurement.NeedsMoreSamples(benchmark_start))
+		{
+			constexpr std::size_t operations = 1000;
+
+			measurement.Start();
+
+			for (std::size_t i = 0; i < operations; ++i)
+			{
+				board.SetPressed(center_index, true);
+
+				for (std::size_t neighbour_index : board.GetNeighboursIndices(center_index))
+				{
+					board.SetPressed(neighbour_index, true);
+				}
+
+				const bool current_pressed = board.IsPressed(center_index);
+				board.ClearPressed();
+				board.SetPressed(center_index, current_pressed);
+			}
+
+			measurement.Stop(operations);
+		}
+
+		Record(name, measurement);
+	}
+
+	/* Saves a board in the middle of a game, then loads it back into another board. One operation is one save or 
+	 * load, which the game has to finish within a frame. */
+	void BenchmarkSnapshot(const BenchmarkSize& size)
+	{
+		const std::string save_name = std::string("snapshot_save/") + size.name_;
+		const std::string load_name = std::string("snapshot_load/") + size.name_;
+
+		if (!IsSelected(save_name) && !IsSelected(load_name))
+		{
+			return;
+		}
+		const char* path = "bench_snapshot.bin";
+
+		Board board(size.width_, size.height_, size.mines_);
+		board.PlaceMines(1, GetCenterIndex(board));
+		board.Reveal(GetCenterIndex(board));
+
+		const SnapshotInfo info = { 12345678, true, false };
+
+		auto benchmark_start = std::chrono::steady_clock::now();
+		Measurement save_measurement;
+
+		while (save_measurement.NeedsMoreSamples(benchmark_start))
+		{
+			save_measurement.Start();
+			const bool saved = SaveSnapshot(path, board, info);
+			save_measurement.Stop(1);
+
+			if (!saved)
+			{
+				ReportFailure(save_name, "snapshot not saved");
+				return;
+			}
+		}
+
+		benchmark_start = std::chrono::steady_clock::now();
+		Measurement load_measurement;
+		Board loaded_board;
+		SnapshotInfo loaded_info = {};
+
+		while (load_measurement.NeedsMoreSamples(benchmark_start))
+		{
+			load_measurement.Start();
+			const bool loaded = LoadSnapshot(path, loaded_board, &loaded_info);
+			load_measurement.Stop(1);
+
+			if (!loaded)
+			{
+				ReportFailure(load_name, "snapshot not loaded");
+				break;
+			}
+		}
+
+		std::remove(path);
+		std::remove((std::string(path) + ".tmp").c_str());
+
+		const BitPlane& uncovered_plane = board.GetUncoveredPlane();
+		const BitPlane& loaded_uncovered_plane = loaded_board.GetUncoveredPlane();
+
+		if (loaded_board.GetSize() != board.GetSize() || loaded_board.GetCoveredSafeCells() != board.GetCoveredSafeCells() || 
+			loaded_info.elapsed_microseconds_ != info.elapsed_microseconds_ || 
+			!std::equal(uncovered_plane.GetWords(), uncovered_plane.GetWords() + uncovered_plane.GetWordCount(), loaded_uncovered_plane.GetWords()))
+		{
+			ReportFailure(load_name, "loaded board differs from the saved one");
+		}
+
+		/* Loading needs a saved file, so both always run, but only the selected names are recorded. */
+		if (IsSelected(save_name))
+		{
+			Record(save_name, save_measurement);
+		}
+
+		if (IsSelected(load_name))
+		{
+			Record(load_name, load_measurement);
+		}
+	}
+
+	/* Reveals the first empty cell of a sparse board, a worst case for the flood fill. One operation is one
+	 * uncovered cell. */
+	void BenchmarkSparseCascade(int width, int height, double density)
+	{
+		const std::string name = "reveal_sparse/" + std::to_string(width) + "x" + std::to_string(height);
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		const auto benchmark_start = std::chrono::steady_clock::now();
+
+		const int mines = static_cast<int>(static_cast<double>(width) * height * density);
+
+		Board board;
+		Measurement measurement;
+		std::uint64_t seed = 0;
+
+		while (measurement.NeedsMoreSamples(benchmark_start))
+		{
+			board.Reset(width, height, mines);
+			board.PlaceMines(seed++);
+
+			std::size_t start_index = 0;
+
+			while (start_index < board.GetSize() && (board.IsMine(start_index) || board.GetMinesInVicinity(start_index) != 0))
+			{
+				++start_index;
+			}
+
+			if (start_index == board.GetSize())
+			{
+				continue;
+			}
+
+			measurement.Start();
+			board.Reveal(start_index);
+			measurement.Stop(board.GetRevealedCells().size());
+		}
+
+		Record(name, measurement);
+	}
+
+	/* Samples mines into a cleared plane with cells excluded and checks the mine count. One operation is one mine. */
+	void BenchmarkPlacement(std::size_t cells, double density)
+	{
+		const std::string name = "placement/" + std::to_string(cells) + "/" + std::to_string(static_cast<int>(density * 100.0)) + "%";
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		const auto benchmark_start = std::chrono::steady_clock::now();
+
+		const std::size_t mines = static_cast<std::size_t>(static_cast<double>(cells) * density);
+		const std::size_t center = cells / 2;
+		const std::vector<std::size_t> excluded_indices = { center - 1, center, center + 1 };
+
+		CounterRng rng(42);
+		BitPlane mine_plane;
+		Measurement measurement;
+
+		while (measurement.NeedsMoreSamples(benchmark_start))
+		{
+			mine_plane.Reset(cells);
+
+			measurement.Start();
+			const std::size_t placed = SampleMines(mine_plane, mines, excluded_indices, rng);
+			measurement.Stop(mines);
+
+			if (placed != mines || mine_plane.Count() != mines || mine_plane.Get(center))
+			{
+				ReportFailure(name, "wrong mine count");
+			}
+		}
+
+		Record(name, measurement);
+	}
+
+	/* Per-cell neighbour loop the kernel replaced, kept to check its output. */
+	void CountNeighbourMinesReference(const BitPlane& mine_plane, int width, int height, NibblePlane& vicinity_plane)
+	{
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				int mines_in_vicinity = 0;
+
+				for (int dy = -1; dy <= 1; ++dy)
+				{
+					for (int dx = -1; dx <= 1; ++dx)
+					{
+						const int nx = x + dx;
+						const int ny = y + dy;
+
+						if ((dx != 0 || dy != 0) && nx >= 0 && nx < width && ny >= 0 && ny < height && mine_plane.Get(static_cast<std::size_t>(ny) * width + nx))
+						{
+							++mines_in_vicinity;
+						}
+					}
+				}
+
+				vicinity_plane.Set(static_cast<std::size_t>(y) * width + x, mines_in_vicinity);
+			}
+		}
+	}
+
+	const char* GetSimdLevelName(SimdLevel simd_level)
+	{
+		switch (simd_level)
+		{
+		case SimdLevel::SCALAR:
+			return "scalar";
+		case SimdLevel::SSE2:
+			return "sse2";
+		case SimdLevel::AVX2:
+			return "avx2";
+		}
+
+		return "unknown";
+	}
+
+	/* Times every supported kernel and checks it against the reference loop. One operation is one cell. */
+	void BenchmarkNeighbourCount(int width, int height, double density)
+	{
+		const std::size_t cells = static_cast<std::size_t>(width) * height;
+		const std::string size_name = std::to_string(width) + "x" + std::to_string(height);
+
+		CounterRng rng(7);
+		BitPlane mine_plane;
+		mine_plane.Reset(cells);
+		SampleMines(mine_plane, static_cast<std::size_t>(cells * density), {}, rng);
+
+		/* The reference loop is slow on large boards, so it only runs once a kernel is selected. */
+		NibblePlane expected;
+
+		for (SimdLevel simd_level : { SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2 })
+		{
+			const std::string name = std::string("neighbour_count/") + GetSimdLevelName(simd_level) + "/" + size_name;
+
+			if (simd_level > GetSupportedSimdLevel() || !IsSelected(name))
+			{
+				continue;
+			}
+
+			if (expected.GetSize() != cells)
+			{
+				expected.Reset(cells);
+				CountNeighbourMinesReference(mine_plane, width, height, expected);
+			}
+
+			const auto benchmark_start = std::chrono::steady_clock::now();
+
+			NibblePlane vicinity_plane;
+			vicinity_plane.Reset(cells);
+
+			Measurement measurement;
+
+			while (measurement.NeedsMoreSamples(benchmark_start))
+			{
+				measurement.Start();
+				CountNeighbourMines(mine_plane, width, height, vicinity_plane, simd_level);
+				measurement.Stop(cells);
+			}
+
+			for (std::size_t i = 0; i < cells; ++i)
+			{
+				if (vicinity_plane.Get(i) != expected.Get(i))
+				{
+					ReportFailure(name, "mismatch against the reference loop");
+					break;
+				}
+			}
+
+			Record(name, measurement);
+		}
+	}
+
+	void WriteJson(FILE* file)
+	{
+		fprintf(file, "{\n  \"benchmarks\": [\n");
+
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			const BenchmarkResult& result = results[i];
+
+			fprintf(file, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"allocations_per_op\": %.4f, \"operations\": %zu}%s\n",
+				result.name_.c_str(), result.ns_per_op_, result.allocations_per_op_, result.operations_, i + 1 < results.size() ? "," : "");
+		}
+
+		fprintf(file, "  ]\n}\n");
+	}
+
+	/* Reads a file written by WriteJson. Only that layout is understood: one benchmark object per line. */
+	bool ReadBaseline(const char* path, std::vector<BenchmarkResult>& baseline)
+	{
+		FILE* file = fopen(path, "r");
+
+		if (file == nullptr)
+		{
+			fprintf(stderr, "Unable to open baseline %s\n", path);
+			return false;
+		}
+
+		char line[512];
+
+		while (fgets(line, sizeof(line), file) != nullptr)
+		{
+			char name[256];
+			BenchmarkResult result{ "", 0.0, 0.0, 0 };
+
+			if (sscanf(line, " {\"name\": \"%255[^\"]\", \"ns_per_op\": %lf, \"allocations_per_op\": %lf, \"operations\": %zu",
+				name, &result.ns_per_op_, &result.allocations_per_op_, &result.operations_) == 4)
+			{
+				result.name_ = name;
+				baseline.push_back(result);
+			}
+		}
+
+		fclose(file);
+
+		return true;
+	}
+
+	/* A benchmark regresses when it allocates more than the baseline or, with a threshold of 0 or more, when it is 
+	 * more than threshold slower. Allocation counts do not depend on the machine, timings do, so timings are only 
+	 * worth comparing against a baseline recorded on the same machine. */
+	bool CompareWithBaseline(const std::vector<BenchmarkResult>& baseline, double threshold)
+	{
+		bool regressed = false;
+
+		fprintf(stderr, "%-36s %14s %14s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+
+		for (const BenchmarkResult& result : results)
+		{
+			const BenchmarkResult* previous = nullptr;
+
+			for (const BenchmarkResult& candidate : baseline)
+			{
+				if (candidate.name_ == result.name_)
+				{
+					previous = &candidate;
+					break;
+				}
+			}
+
+			if (previous == nullptr)
+			{
+				fprintf(stderr, "%-36s %14s %14.3f %9s\n", result.name_.c_str(), "-", result.ns_per_op_, "new");
+				continue;
+			}
+
+			const double change = previous->ns_per_op_ > 0.0 ? result.ns_per_op_ / previous->ns_per_op_ - 1.0 : 0.0;
+			const bool slower = threshold >= 0.0 && change > threshold;
+			const bool allocates_more = result.allocations_per_op_ > previous->allocations_per_op_ + 0.01;
+
+			fprintf(stderr, "%-36s %14.3f %14.3f %+8.1f%%%s%s\n", result.name_.c_str(), previous->ns_per_op_, result.ns_per_op_,
+				change * 100.0, slower ? "  SLOWER" : "", allocates_more ? "  MORE ALLOCATIONS" : "");
+
+			regressed = regressed || slower || allocates_more;
+		}
+
+		return !regressed;
+	}
+
+	void PrintUsage(const char* program)
+	{
+		fprintf(stderr, "Usage: %s [--output FILE] [--baseline FILE] [--threshold PERCENT] [--filter TEXT]\n", program);
+	}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	const char* output_path = nullptr;
+	const char* baseline_path = nullptr;
+	double threshold = -1.0;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--output") == 0)
+		{
+			output_path = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "--baseline") == 0)
+		{
+			baseline_path = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "--threshold") == 0)
+		{
+			threshold = std::atof(argv[i + 1]) / 100.0;
+		}
+		else if (strcmp(argv[i], "--filter") == 0)
+		{
+			filter = argv[i + 1];
+		}
+		else
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (argc % 2 == 0)
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	const std::vector<BenchmarkSize> sizes = {
+		{ "small", GetBoardPreset(BoardSize::SMALL).width_, GetBoardPreset(BoardSize::SMALL).height_, GetBoardPreset(BoardSize::SMALL).mines_ },
+		{ "medium", GetBoardPreset(BoardSize::MEDIUM).width_, GetBoardPreset(BoardSize::MEDIUM).height_, GetBoardPreset(BoardSize::MEDIUM).mines_ },
+		{ "large", GetBoardPreset(BoardSize::LARGE).width_, GetBoardPreset(BoardSize::LARGE).height_, GetBoardPreset(BoardSize::LARGE).mines_ },
+		{ "1024x1024", 1024, 1024, 1024 * 1024 / 8 },
+		{ "4096x4096", 4096, 4096, 4096 * 4096 / 8 }
+	};
+
+	using SizeBenchmark = void (*)(const BenchmarkSize&);
+
+	/* Each benchmark checks the filter against the names it records. */
+	const std::vector<SizeBenchmark> size_benchmarks = {
+		BenchmarkGenerateBoard, 
+		BenchmarkToggleFlag, 
+		BenchmarkRevealSingle, 
+		BenchmarkRevealCascade, 
+		BenchmarkChord, 
+		BenchmarkNeighbourIndices, 
+		BenchmarkResetPressed, 
+		BenchmarkSnapshot
+	};
+
+	for (SizeBenchmark size_benchmark : size_benchmarks)
+	{
+		for (const BenchmarkSize& size : sizes)
+		{
+			size_benchmark(size);
+		}
+	}
+
+	BenchmarkSparseCascade(1024, 1024, 0.01);
+	BenchmarkSparseCascade(4096, 4096, 0.01);
+
+	BenchmarkNeighbourCount(31, 17, 0.3);
+	BenchmarkNeighbourCount(1023, 1023, 0.2);
+	BenchmarkNeighbourCount(4096, 4096, 0.2);
+
+	for (std::size_t cells : { std::size_t{ 1000000 }, std::size_t{ 10000000 } })
+	{
+		BenchmarkPlacement(cells, 0.10);
+		BenchmarkPlacement(cells, 0.50);
+		BenchmarkPlacement(cells, 0.95);
+	}
+
+	WriteJson(stdout);
+
+	if (output_path != nullptr)
+	{
+		FILE* file = fopen(output_path, "w");
+
+		if (file == nullptr)
+		{
+			fprintf(stderr, "Unable to write %s\n", output_path);
+			return 1;
+		}
+
+		WriteJson(file);
+		fclose(file);
+	}
+
+	bool passed = !checks_failed;
+
+	if (baseline_path != nullptr)
+	{
+		std::vector<BenchmarkResult> baseline;
+
+		passed = ReadBaseline(baseline_path, baseline) && CompareWithBaseline(baseline, threshold) && passed;
+	}
+
+	return passed ? 0 : 1;
+}
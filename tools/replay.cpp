@@ -0,0 +1,168 @@
+#include "Board.hpp"
+#include "BoardGenerator.hpp"
+#include "Replay.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	struct Totals
+	{
+		std::size_t games_;
+		std::size_t won_;
+		std::size_t lost_;
+		std::size_t events_;
+		std::size_t cells_revealed_;
+	};
+
+	const char* GetStateName(BoardState state)
+	{
+		switch (state)
+		{
+		case BoardState::PLAYING:
+			return "unfinished";
+		case BoardState::WON:
+			return "won";
+		case BoardState::LOST:
+			return "lost";
+		}
+
+		return "unknown";
+	}
+
+	void FinishGame(const Board& board, const ReplayGame& game, std::size_t events, bool verbose, Totals& totals)
+	{
+		++totals.games_;
+		totals.won_ += board.GetState() == BoardState::WON;
+		totals.lost_ += board.GetState() == BoardState::LOST;
+
+		if (verbose)
+		{
+			printf("game %zu: %dx%d, %d mines, seed %llu%s: %s after %zu events\n", totals.games_, game.width_, game.height_, 
+				game.mines_, static_cast<unsigned long long>(game.seed_), game.no_guess_ ? ", no guess" : "", 
+				GetStateName(board.GetState()), events);
+		}
+	}
+
+	/* Plays every game of the log through the board engine as fast as possible. Moves are applied exactly as the 
+	 * game applied them, mines are placed on the first reveal from the recorded seed. */
+	bool Play(const char* path, bool verbose, ThreadPool& thread_pool)
+	{
+		ReplayReader reader;
+
+		if (!reader.Open(path))
+		{
+			return false;
+		}
+
+		Totals totals = {};
+		Board board;
+		ReplayGame game = {};
+		ReplayRecord record;
+		bool in_game = false;
+		std::size_t events = 0;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		while (reader.Next(&record))
+		{
+			if (record.action_ == ReplayAction::NEW_GAME)
+			{
+				if (in_game)
+				{
+					FinishGame(board, game, events, verbose, totals);
+				}
+
+				game = record.game_;
+				board.Reset(game.width_, game.height_, game.mines_);
+				in_game = true;
+				events = 0;
+				continue;
+			}
+
+			if (!in_game || record.cell_ >= board.GetSize())
+			{
+				printf("Damaged record after %zu games\n", totals.games_);
+				break;
+			}
+
+			++events;
+			++totals.events_;
+
+			if (record.action_ == ReplayAction::FLAG)
+			{
+				board.ToggleFlag(record.cell_);
+				continue;
+			}
+
+			if (!board.AreMinesPlaced())
+			{
+				if (game.no_guess_)
+				{
+					GenerateNoGuessBoard(board, game.seed_, record.cell_, thread_pool);
+				}
+				else
+				{
+					board.PlaceMines(game.seed_, record.cell_);
+				}
+			}
+
+			if (record.action_ == ReplayAction::REVEAL)
+			{
+				board.Reveal(record.cell_);
+			}
+			else
+			{
+				board.Chord(record.cell_);
+			}
+
+			totals.cells_revealed_ += board.GetRevealedCells().size();
+		}
+
+		if (in_game)
+		{
+			FinishGame(board, game, events, verbose, totals);
+		}
+
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		printf("%zu games (%zu won, %zu lost, %zu unfinished), %zu events in %.3f s: %.0f events/s, %.2f Mcells/s\n", 
+			totals.games_, totals.won_, totals.lost_, totals.games_ - totals.won_ - totals.lost_, totals.events_, seconds, 
+			seconds > 0.0 ? totals.events_ / seconds : 0.0, seconds > 0.0 ? totals.cells_revealed_ / seconds / 1e6 : 0.0);
+
+		return true;
+	}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	const char* path = nullptr;
+	bool verbose = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--verbose") == 0)
+		{
+			verbose = true;
+		}
+		else
+		{
+			path = argv[i];
+		}
+	}
+
+	if (path == nullptr)
+	{
+		printf("Usage: %s [--verbose] REPLAY_LOG\n", argv[0]);
+		return 1;
+	}
+
+	ThreadPool thread_pool;
+
+	return Play(path, verbose, thread_pool) ? 0 : 1;
+}
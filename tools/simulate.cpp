@@ -0,0 +1,581 @@
+#include "Board.hpp"
+#include "ProbabilityEngine.hpp"
+#include "Random.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+	/* Plays one side of a game. Every worker thread owns its own strategy, so implementations need no locking. */
+	class Strategy
+	{
+	public:
+		virtual ~Strategy() = default;
+
+		/* Called before every game. */
+		virtual void NewGame(std::uint64_t seed)
+		{
+			(void) seed;
+		}
+
+		/* Picks the next move. Returns false to give up the game. */
+		virtual bool GetMove(const Board& board, std::size_t* index, bool* flag) = 0;
+	};
+
+	/* Uncovers random covered cells and never flags. Baseline for the other strategies. */
+	class RandomStrategy : public Strategy
+	{
+	private:
+		CounterRng rng_;
+
+	public:
+		RandomStrategy() : rng_(0)
+		{
+		}
+
+		void NewGame(std::uint64_t seed) override
+		{
+			rng_ = CounterRng(seed, 1);
+		}
+
+		bool GetMove(const Board& board, std::size_t* index, bool* flag) override
+		{
+			std::size_t candidate = 0;
+
+			do
+			{
+				candidate = static_cast<std::size_t>(rng_.UniformBelow(board.GetSize()));
+			}
+			while (board.IsUncovered(candidate) || board.IsFlagged(candidate));
+
+			*index = candidate;
+			*flag = false;
+
+			return true;
+		}
+	};
+
+	/* Starts in the middle, plays every forced move the Solver finds and otherwise uncovers the covered cell
+	 * with the lowest exact mine probability. */
+	class SolverStrategy : public Strategy
+	{
+	private:
+		Solver solver_;
+		ProbabilityEngine probability_engine_;
+
+	public:
+		/* A few boards need hundreds of millions of search nodes for exact probabilities. A guess does not 
+		 * need them, and they would dominate the latency percentiles. */
+		SolverStrategy()
+		{
+			probability_engine_.SetNodeLimit(1000000);
+		}
+
+		bool GetMove(const Board& board, std::size_t* index, bool* flag) override
+		{
+			if (!board.AreMinesPlaced())
+			{
+				*index = board.GetIndex(board.GetWidth() / 2, board.GetHeight() / 2);
+				*flag = false;
+
+				return true;
+			}
+
+			if (solver_.GetHint(board, index, flag))
+			{
+				return true;
+			}
+
+			probability_engine_.Update(board);
+
+			float best_probability = 2.0f;
+
+			for (std::size_t i = 0; i < board.GetSize(); ++i)
+			{
+				if (!board.IsUncovered(i) && !board.IsFlagged(i) && probability_engine_.GetMineProbability(i) < best_probability)
+				{
+					best_probability = probability_engine_.GetMineProbability(i);
+					*index = i;
+				}
+			}
+
+			*flag = false;
+
+			return best_probability <= 1.0f;
+		}
+	};
+
+	/* Runs a bot as a child process and talks to it over its standard input and output. Before every move the
+	 * bot gets a line "<width> <height> <mines left>" followed by one line per row, with '#' for covered cells,
+	 * 'F' for flags and '0' to '8' for uncovered cells. It answers "R <x> <y>" to uncover or "F <x> <y>" to
+	 * toggle a flag. */
+	class ExternalStrategy : public Strategy
+	{
+	private:
+		pid_t pid_;
+		FILE* to_bot_;
+		FILE* from_bot_;
+		std::string state_;
+
+	public:
+		explicit ExternalStrategy(const std::string& command) :
+			pid_(-1),
+			to_bot_(nullptr),
+			from_bot_(nullptr)
+		{
+			int to_bot_pipe[2];
+			int from_bot_pipe[2];
+
+			/* Workers start their bots concurrently, so without O_CLOEXEC a bot could inherit the write end of a 
+			 * sibling's stdin and keep that sibling from ever seeing EOF. dup2 clears the flag on stdin and stdout. */
+			if (pipe2(to_bot_pipe, O_CLOEXEC) != 0)
+			{
+				printf("Failed to create a pipe for the bot\n");
+				return;
+			}
+
+			if (pipe2(from_bot_pipe, O_CLOEXEC) != 0)
+			{
+				printf("Failed to create a pipe for the bot\n");
+				close(to_bot_pipe[0]);
+				close(to_bot_pipe[1]);
+				return;
+			}
+
+			pid_ = fork();
+
+			if (pid_ == 0)
+			{
+				dup2(to_bot_pipe[0], STDIN_FILENO);
+				dup2(from_bot_pipe[1], STDOUT_FILENO);
+				close(to_bot_pipe[0]);
+				close(to_bot_pipe[1]);
+				close(from_bot_pipe[0]);
+				close(from_bot_pipe[1]);
+
+				execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+				_exit(127);
+			}
+
+			close(to_bot_pipe[0]);
+			close(from_bot_pipe[1]);
+
+			if (pid_ < 0)
+			{
+				printf("Failed to start the bot \"%s\"\n", command.c_str());
+				close(to_bot_pipe[1]);
+				close(from_bot_pipe[0]);
+				return;
+			}
+
+			to_bot_ = fdopen(to_bot_pipe[1], "w");
+			from_bot_ = fdopen(from_bot_pipe[0], "r");
+		}
+
+		~ExternalStrategy() override
+		{
+			if (to_bot_ != nullptr)
+			{
+				fclose(to_bot_);
+			}
+
+			if (from_bot_ != nullptr)
+			{
+				fclose(from_bot_);
+			}
+
+			if (pid_ > 0)
+			{
+				waitpid(pid_, nullptr, 0);
+			}
+		}
+
+		bool GetMove(const Board& board, std::size_t* index, bool* flag) override
+		{
+			if (to_bot_ == nullptr || from_bot_ == nullptr)
+			{
+				return false;
+			}
+
+			state_.clear();
+
+			for (int y = 0; y < board.GetHeight(); ++y)
+			{
+				for (int x = 0; x < board.GetWidth(); ++x)
+				{
+					const std::size_t cell_index = board.GetIndex(x, y);
+
+					if (board.IsFlagged(cell_index))
+					{
+						state_.push_back('F');
+					}
+					else if (!board.IsUncovered(cell_index))
+					{
+						state_.push_back('#');
+					}
+					else
+					{
+						state_.push_back(static_cast<char>('0' + board.GetMinesInVicinity(cell_index)));
+					}
+				}
+
+				state_.push_back('\n');
+			}
+
+			fprintf(to_bot_, "%d %d %d\n%s", board.GetWidth(), board.GetHeight(), board.GetMinesLeft(), state_.c_str());
+			fflush(to_bot_);
+
+			char action = 0;
+			int x = 0;
+			int y = 0;
+
+			if (fscanf(from_bot_, " %c %d %d", &action, &x, &y) != 3 || (action != 'R' && action != 'F') || !board.Contains(x, y))
+			{
+				return false;
+			}
+
+			*index = board.GetIndex(x, y);
+			*flag = action == 'F';
+
+			return true;
+		}
+	};
+
+	struct Options
+	{
+		std::size_t games_;
+		std::size_t threads_;
+		std::uint64_t seed_;
+		std::string strategy_;
+		std::string bot_command_;
+		std::vector<BoardSize> board_sizes_;
+	};
+
+	struct WorkerResult
+	{
+		std::size_t wins_;
+		std::size_t cells_revealed_;
+		std::size_t moves_;
+		std::vector<double> game_microseconds_;
+	};
+
+	std::unique_ptr<Strategy> CreateStrategy(const Options& options)
+	{
+		if (options.strategy_ == "random")
+		{
+			return std::make_unique<RandomStrategy>();
+		}
+
+		if (options.strategy_ == "solver")
+		{
+			return std::make_unique<SolverStrategy>();
+		}
+
+		if (options.strategy_ == "external")
+		{
+			return std::make_unique<ExternalStrategy>(options.bot_command_);
+		}
+
+		return nullptr;
+	}
+
+	const char* GetBoardSizeName(BoardSize board_size)
+	{
+		switch (board_size)
+		{
+		case BoardSize::SMALL:
+			return "small";
+		case BoardSize::MEDIUM:
+			return "medium";
+		case BoardSize::LARGE:
+			return "large";
+		case BoardSize::GIANT:
+			return "giant";
+		case BoardSize::CUSTOM:
+			return "custom";
+		}
+
+		return "unknown";
+	}
+
+	/* Plays one game to the end. The first uncover never hits a mine, like in the game. */
+	void PlayGame(Board& board, Strategy& strategy, std::uint64_t seed, WorkerResult& result)
+	{
+		board.Reset();
+		strategy.NewGame(seed);
+
+		/* Strategies that only toggle flags would never finish. */
+		const std::size_t move_limit = board.GetSize() * 4;
+		std::size_t moves = 0;
+
+		while (board.GetState() == BoardState::PLAYING && moves < move_limit)
+		{
+			std::size_t index = 0;
+			bool flag = false;
+
+			if (!strategy.GetMove(board, &index, &flag))
+			{
+				break;
+			}
+
+			++moves;
+
+			if (flag)
+			{
+				board.ToggleFlag(index);
+				continue;
+			}
+
+			if (!board.AreMinesPlaced())
+			{
+				board.PlaceMines(seed, index);
+			}
+
+			board.Reveal(index);
+			result.cells_revealed_ += board.GetRevealedCells().size();
+		}
+
+		result.moves_ += moves;
+
+		if (board.GetState() == BoardState::WON)
+		{
+			++result.wins_;
+		}
+	}
+
+	double GetPercentile(const std::vector<double>& sorted_values, double percentile)
+	{
+		if (sorted_values.empty())
+		{
+			return 0.0;
+		}
+
+		const std::size_t rank = static_cast<std::size_t>(percentile * (sorted_values.size() - 1) + 0.5);
+
+		return sorted_values[rank];
+	}
+
+	/* Plays options.games_ games of one preset. Each worker pulls blocks of games from a shared counter,
+	 * game i always uses the same seed, so results do not depend on the thread count. */
+	bool Simulate(const Options& options, BoardSize board_size, ThreadPool& thread_pool)
+	{
+		constexpr std::size_t block_size = 64;
+
+		const BoardPreset preset = GetBoardPreset(board_size);
+
+		std::vector<WorkerResult> results(thread_pool.GetThreadCount());
+		std::atomic<std::size_t> next_game(0);
+		std::atomic<bool> failed(false);
+
+		ThreadPool::TaskGroup task_group;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		for (WorkerResult& result : results)
+		{
+			result = WorkerResult{ 0, 0, 0, {} };
+
+			thread_pool.Submit(task_group, [&options, &preset, &result, &next_game, &failed]()
+			{
+				std::unique_ptr<Strategy> strategy = CreateStrategy(options);
+
+				if (strategy == nullptr)
+				{
+					failed = true;
+					return;
+				}
+
+				Board board(preset.width_, preset.height_, preset.mines_);
+
+				for (;;)
+				{
+					const std::size_t first_game = next_game.fetch_add(block_size);
+
+					if (first_game >= options.games_)
+					{
+						break;
+					}
+
+					const std::size_t last_game = std::min(first_game + block_size, options.games_);
+
+					for (std::size_t game = first_game; game < last_game; ++game)
+					{
+						const auto game_start = std::chrono::steady_clock::now();
+						PlayGame(board, *strategy, CounterRng(options.seed_, game)(), result);
+						const auto game_end = std::chrono::steady_clock::now();
+
+						result.game_microseconds_.push_back(std::chrono::duration<double, std::micro>(game_end - game_start).count());
+					}
+				}
+			});
+		}
+
+		thread_pool.Wait(task_group);
+
+		const auto end = std::chrono::steady_clock::now();
+
+		if (failed)
+		{
+			return false;
+		}
+
+		std::size_t wins = 0;
+		std::size_t cells_revealed = 0;
+		std::size_t moves = 0;
+		std::vector<double> game_microseconds;
+		game_microseconds.reserve(options.games_);
+
+		for (const WorkerResult& result : results)
+		{
+			wins += result.wins_;
+			cells_revealed += result.cells_revealed_;
+			moves += result.moves_;
+			game_microseconds.insert(game_microseconds.end(), result.game_microseconds_.begin(), result.game_microseconds_.end());
+		}
+
+		std::sort(game_microseconds.begin(), game_microseconds.end());
+
+		const double seconds = std::chrono::duration<double>(end - start).count();
+		const double games = static_cast<double>(options.games_);
+
+		printf("%-6s %-8s %10zu games: win %6.2f%%, %11.0f games/s, %8.2f Mcells/s, %6.1f moves/game, "
+			"game latency p50 %8.1f us p90 %8.1f us p99 %8.1f us max %8.1f us\n",
+			GetBoardSizeName(board_size), options.strategy_.c_str(), options.games_,
+			games > 0.0 ? wins * 100.0 / games : 0.0, seconds > 0.0 ? games / seconds : 0.0,
+			seconds > 0.0 ? cells_revealed / seconds / 1e6 : 0.0, games > 0.0 ? moves / games : 0.0,
+			GetPercentile(game_microseconds, 0.50), GetPercentile(game_microseconds, 0.90),
+			GetPercentile(game_microseconds, 0.99), GetPercentile(game_microseconds, 1.0));
+
+		return true;
+	}
+
+	void PrintUsage(const char* program)
+	{
+		printf("Usage: %s [--games N] [--strategy random|solver|external] [--bot COMMAND] [--threads N] "
+			"[--seed N] [--size small|medium|large|giant|all]\n"
+			"Without --size the small, medium and large presets are played, all adds giant.\n", program);
+	}
+
+	bool ParseOptions(int argc, char* argv[], Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const char* argument = argv[i];
+			const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+			if (value == nullptr)
+			{
+				return false;
+			}
+
+			if (strcmp(argument, "--games") == 0)
+			{
+				options.games_ = std::strtoull(value, nullptr, 10);
+			}
+			else if (strcmp(argument, "--strategy") == 0)
+			{
+				options.strategy_ = value;
+			}
+			else if (strcmp(argument, "--bot") == 0)
+			{
+				options.bot_command_ = value;
+			}
+			else if (strcmp(argument, "--threads") == 0)
+			{
+				options.threads_ = std::strtoull(value, nullptr, 10);
+			}
+			else if (strcmp(argument, "--seed") == 0)
+			{
+				options.seed_ = std::strtoull(value, nullptr, 10);
+			}
+			else if (strcmp(argument, "--size") == 0)
+			{
+				if (strcmp(value, "small") == 0)
+				{
+					options.board_sizes_ = { BoardSize::SMALL };
+				}
+				else if (strcmp(value, "medium") == 0)
+				{
+					options.board_sizes_ = { BoardSize::MEDIUM };
+				}
+				else if (strcmp(value, "large") == 0)
+				{
+					options.board_sizes_ = { BoardSize::LARGE };
+				}
+				else if (strcmp(value, "giant") == 0)
+				{
+					options.board_sizes_ = { BoardSize::GIANT };
+				}
+				else if (strcmp(value, "all") == 0)
+				{
+					options.board_sizes_ = { BoardSize::SMALL, BoardSize::MEDIUM, BoardSize::LARGE, BoardSize::GIANT };
+				}
+				else
+				{
+					return false;
+				}
+			}
+			else
+			{
+				return false;
+			}
+
+			++i;
+		}
+
+		if (options.strategy_ != "random" && options.strategy_ != "solver" && options.strategy_ != "external")
+		{
+			return false;
+		}
+
+		return options.strategy_ != "external" || !options.bot_command_.empty();
+	}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	Options options{ 100000, 0, 1, "solver", "", { BoardSize::SMALL, BoardSize::MEDIUM, BoardSize::LARGE } };
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	/* A bot that exits early must not kill the harness. */
+	signal(SIGPIPE, SIG_IGN);
+
+	ThreadPool thread_pool(options.threads_);
+
+	printf("%zu threads, seed %llu\n", thread_pool.GetThreadCount(), static_cast<unsigned long long>(options.seed_));
+
+	for (BoardSize board_size : options.board_sizes_)
+	{
+		if (!Simulate(options, board_size, thread_pool))
+		{
+			printf("Failed to create the %s strategy\n", options.strategy_.c_str());
+			return 1;
+		}
+	}
+
+	return 0;
+}